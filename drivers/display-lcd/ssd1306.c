@@ -7,30 +7,195 @@
 #include "pico/stdlib.h"
 #include "pico/binary_info.h"
 #include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "inc/probe.h"
 
 
+// Quadro com cabeçalho: o byte de controle 0x40 fica logo antes dos pixels,
+// então uma faixa do framebuffer vai para o I2C em uma transação, sem cópia.
+// O cabeçalho tem 4 bytes para manter os pixels alinhados em palavras.
+#define SSD1306_FRAME_HEADER 4
+static uint8_t SSD1306_Frame[SSD1306_FRAME_HEADER + SSD1306_BUFFER_SIZE] __attribute__((aligned(4)));
+#define SSD1306_Buffer (&SSD1306_Frame[SSD1306_FRAME_HEADER]) //Buffer com o estado de cada pixel (1 bit por pixel). De tam.: 1024 bytes.
+
 #if defined(SSD1306_USE_I2C) //Verifica se o protocolo I2C está habilitado.
 
 //Define os pinos SDA (dados) como GPIO14 e SCL (clock) como GPIO15.
 const uint8_t I2C_SDA_PIN = 14;
 const uint8_t I2C_SCL_PIN = 15;
 
+// Fluxo de palavras para o registrador IC_DATA_CMD do I2C, enviado por DMA.
+// Cada palavra carrega um byte e, no último byte de cada transação, o bit de STOP.
+// Funciona como o segundo framebuffer: o quadro seguinte é desenhado em
+// SSD1306_Buffer enquanto este ainda está sendo transmitido.
+#define SSD1306_TX_WINDOW_WORDS 7 // Byte de controle + comandos 0x21 e 0x22 com argumentos
+// Pior caso: uma janela por página, cada uma com comandos, byte de controle e a página inteira
+static uint16_t SSD1306_TxBuffer[(SSD1306_HEIGHT / 8) * (SSD1306_TX_WINDOW_WORDS + 1 + SSD1306_WIDTH)];
+static int ssd1306_dma_chan = -1;
+static volatile SSD1306_FlushCallback_t ssd1306_flush_callback = NULL;
+static uint32_t ssd1306_tx_bytes = 0; // Bytes enviados ao display (comandos, controle e dados)
+
+// Fim da alimentação da FIFO pelo DMA (DMA_IRQ_1; a captura do microfone usa a DMA_IRQ_0)
+static void ssd1306_DmaIrqHandler(void) {
+    if (ssd1306_dma_chan >= 0 && dma_channel_get_irq1_status(ssd1306_dma_chan)) {
+        dma_channel_acknowledge_irq1(ssd1306_dma_chan);
+        if (ssd1306_flush_callback) {
+            ssd1306_flush_callback();
+        }
+    }
+}
+
+// Configura o canal de DMA que alimenta a FIFO de transmissão do I2C
+static void ssd1306_DmaInit(void) {
+    ssd1306_dma_chan = dma_claim_unused_channel(true);
+
+    dma_channel_config cfg = dma_channel_get_default_config(ssd1306_dma_chan);
+    channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+    channel_config_set_read_increment(&cfg, true);
+    channel_config_set_write_increment(&cfg, false);
+    channel_config_set_dreq(&cfg, i2c_get_dreq(SSD1306_I2C_PORT, true));
+    dma_channel_configure(ssd1306_dma_chan, &cfg, &i2c_get_hw(SSD1306_I2C_PORT)->data_cmd, SSD1306_TxBuffer, 0, false);
+
+    dma_channel_set_irq1_enabled(ssd1306_dma_chan, true);
+    irq_add_shared_handler(DMA_IRQ_1, ssd1306_DmaIrqHandler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+}
+
+/**
+ * @brief Indica se há um quadro sendo transmitido.
+ * @return 1 enquanto o DMA alimenta a FIFO ou o barramento ainda está ativo.
+ */
+uint8_t ssd1306_IsBusy(void) {
+    if (ssd1306_dma_chan < 0) {
+        return 0;
+    }
+    i2c_hw_t *hw = i2c_get_hw(SSD1306_I2C_PORT);
+    return dma_channel_is_busy(ssd1306_dma_chan) ||
+           !(hw->status & I2C_IC_STATUS_TFE_BITS) ||
+           (hw->status & I2C_IC_STATUS_ACTIVITY_BITS);
+}
+
+/**
+ * @brief Espera o fim da transmissão assíncrona em andamento, se houver.
+ */
+void ssd1306_WaitForFlush(void) {
+    while (ssd1306_IsBusy()) {
+        tight_loop_contents();
+    }
+    // Limpa um eventual abort (NACK) para não bloquear a próxima transferência
+    (void)i2c_get_hw(SSD1306_I2C_PORT)->clr_tx_abrt;
+}
+
+/**
+ * @brief Registra a função chamada quando o DMA termina de entregar um quadro.
+ * @param callback Função chamada em contexto de interrupção (NULL desativa).
+ * @note Podem restar até 16 bytes na FIFO; use ssd1306_IsBusy() para saber se o barramento terminou.
+ */
+void ssd1306_SetFlushCallback(SSD1306_FlushCallback_t callback) {
+    ssd1306_flush_callback = callback;
+}
+
+// Lote de comandos: vários comandos sob um único byte de controle 0x00,
+// enviados em uma transação (um START, um endereço e um STOP)
+#define SSD1306_CMD_BATCH_MAX 32
+static uint8_t ssd1306_cmd_batch[1 + SSD1306_CMD_BATCH_MAX] = { 0x00 }; // Byte de controle 0x00 (indica que são comandos)
+static uint8_t ssd1306_cmd_batch_len = 0;
+static uint8_t ssd1306_cmd_batch_open = 0;
+
+// Envia os comandos acumulados, se houver
+static void ssd1306_FlushCommands(void) {
+    if (ssd1306_cmd_batch_len == 0) {
+        return;
+    }
+    ssd1306_WaitForFlush();          // Não intercala com um quadro em transmissão
+    i2c_write_blocking(SSD1306_I2C_PORT, SSD1306_I2C_ADDR, ssd1306_cmd_batch, 1 + ssd1306_cmd_batch_len, false);
+    ssd1306_tx_bytes += 1 + ssd1306_cmd_batch_len;
+    ssd1306_cmd_batch_len = 0;
+}
+
+/**
+ * @brief Abre um lote: os comandos seguintes são acumulados até ssd1306_EndCommands().
+ */
+void ssd1306_BeginCommands(void) {
+    ssd1306_cmd_batch_open = 1;
+}
+
+/**
+ * @brief Fecha o lote e envia os comandos acumulados em uma transação.
+ */
+void ssd1306_EndCommands(void) {
+    ssd1306_cmd_batch_open = 0;
+    ssd1306_FlushCommands();
+}
+
 // Enviar um byte para o registrador de comando
 void ssd1306_WriteCommand(uint8_t byte) {
-    uint8_t buffer[2];           // Buffer contendo o registrador e o dado (Cria um buffer de 2 bytes.)
-    buffer[0] = 0x00;            // Endereço do registrador, define o byte de controle como 0x00 (indica que é um comando).
-    buffer[1] = byte;            // Armazena o comando a ser enviado. Dado a ser enviado 
+    ssd1306_cmd_batch[1 + ssd1306_cmd_batch_len++] = byte;
+    // Fora de um lote envia na hora; um lote cheio é dividido (o display
+    // mantém o estado do comando entre transações)
+    if (!ssd1306_cmd_batch_open || ssd1306_cmd_batch_len == SSD1306_CMD_BATCH_MAX) {
+        ssd1306_FlushCommands();
+    }
+}
 
-    i2c_write_blocking(SSD1306_I2C_PORT, SSD1306_I2C_ADDR, buffer, sizeof(buffer), false); // Envia o buffer via I2C para o endereço do display.
+/**
+ * @brief Envia uma sequência de comandos em uma transação.
+ * @param cmds Comandos e seus argumentos.
+ * @param count Número de bytes.
+ */
+void ssd1306_WriteCommands(const uint8_t* cmds, size_t count) {
+    uint8_t was_open = ssd1306_cmd_batch_open;
+    ssd1306_cmd_batch_open = 1;
+    for (size_t i = 0; i < count; i++) {
+        ssd1306_WriteCommand(cmds[i]);
+    }
+    ssd1306_cmd_batch_open = was_open;
+    if (!was_open) {
+        ssd1306_FlushCommands();
+    }
+}
+
+// Envia dados que estão dentro do framebuffer: o byte anterior é trocado
+// temporariamente pelo byte de controle 0x40 (indica que são dados)
+static void ssd1306_WriteFrameData(uint8_t* buffer, size_t buff_size) {
+    ssd1306_FlushCommands(); // Comandos pendentes vêm antes dos dados
+    uint8_t saved = buffer[-1];
+    buffer[-1] = 0x40;
+    i2c_write_blocking(SSD1306_I2C_PORT, SSD1306_I2C_ADDR, buffer - 1, buff_size + 1, false);
+    buffer[-1] = saved;
+    ssd1306_tx_bytes += buff_size + 1;
 }
 
 // Enviar dados
 void ssd1306_WriteData(uint8_t* buffer, size_t buff_size) {
-    uint8_t temp_buffer[buff_size + 1]; // Cria um buffer temporário com espaço para o byte de controle e os dados.
-    temp_buffer[0] = 0x40;             // Define o byte de controle como 0x40 (indica que são dados).
-    memcpy(&temp_buffer[1], buffer, buff_size); // Copia os dados para o buffer temporário
+    ssd1306_FlushCommands();
+    ssd1306_WaitForFlush();
+
+    if (buffer >= SSD1306_Buffer && buffer + buff_size <= SSD1306_Buffer + SSD1306_BUFFER_SIZE) {
+        ssd1306_WriteFrameData(buffer, buff_size); // Sem cópia
+        return;
+    }
 
-    i2c_write_blocking(SSD1306_I2C_PORT, SSD1306_I2C_ADDR, temp_buffer, sizeof(temp_buffer), false); // Envia o buffer via I2C.
+    // Buffers externos vão em partes; o ponteiro de RAM do display continua entre transações
+    static uint8_t chunk[1 + 32];
+    chunk[0] = 0x40;
+    while (buff_size > 0) {
+        size_t len = (buff_size < sizeof(chunk) - 1) ? buff_size : sizeof(chunk) - 1;
+        memcpy(&chunk[1], buffer, len);
+        i2c_write_blocking(SSD1306_I2C_PORT, SSD1306_I2C_ADDR, chunk, len + 1, false);
+        ssd1306_tx_bytes += len + 1;
+        buffer += len;
+        buff_size -= len;
+    }
+}
+
+/**
+ * @brief Total de bytes enviados ao display desde o boot.
+ * @return Soma dos bytes de comando, controle e dados (sem contar endereço, START e STOP).
+ */
+uint32_t ssd1306_GetTxByteCount(void) {
+    return ssd1306_tx_bytes;
 }
 
 #else
@@ -38,7 +203,26 @@ void ssd1306_WriteData(uint8_t* buffer, size_t buff_size) {
 #endif
 
 
-static uint8_t SSD1306_Buffer[SSD1306_BUFFER_SIZE]; //Cria um buffer para armazenar o estado de cada pixel (1 bit por pixel). De tam.: 1024 bytes.
+#if (SSD1306_WIDTH % 4) != 0
+#error "SSD1306_WIDTH must be a multiple of 4 (dirty tracking compares 32-bit words)"
+#endif
+#if (SSD1306_BUFFER_SIZE % 16) != 0
+#error "SSD1306_BUFFER_SIZE must be a multiple of 16 (ssd1306_LoadFrame copies 4 words per step)"
+#endif
+
+// Cópia do que está na RAM do display; a diferença para SSD1306_Buffer é o que precisa ser enviado
+static uint8_t SSD1306_Shadow[SSD1306_BUFFER_SIZE] __attribute__((aligned(4)));
+static uint8_t SSD1306_ShadowValid = 0; // 0 força o envio do quadro inteiro
+
+// Janelas vizinhas são unidas quando os bytes repetidos custam menos que uma transação a mais
+#define SSD1306_DIRTY_MERGE_SLACK 12
+
+// Retângulo de colunas x páginas a ser enviado com os comandos 0x21 e 0x22
+typedef struct {
+    uint8_t x0, x1;  // Colunas inclusivas
+    uint8_t p0, p1;  // Páginas inclusivas
+    uint16_t bytes;  // Bytes alterados dentro da janela
+} SSD1306_Window_t;
 
 // Objeto display
 static SSD1306_t SSD1306;
@@ -53,101 +237,82 @@ SSD1306_Error_t ssd1306_FillBuffer(uint8_t* buf, uint32_t len) {
     return ret;
 }
 
-/* Initialize the oled screen */
-void ssd1306_Init(void) { 
-    
-    sleep_ms(100); // Espera o display inicializar
-    i2c_init(i2c1, SSD1306_I2C_CLK * 1000); // Inicializa I2C
-    // Configura pinos
-    gpio_set_function(I2C_SDA_PIN, GPIO_FUNC_I2C); 
-    gpio_set_function(I2C_SCL_PIN, GPIO_FUNC_I2C);
-    // Habilita pull-ups
-    gpio_pull_up(I2C_SDA_PIN);
-    gpio_pull_up(I2C_SCL_PIN);
-
-    // Inicializa o display 
-    ssd1306_SetDisplayOn(0); // Desliga o display temporariamente
-    // Envia comandos de configuração
-    ssd1306_WriteCommand(0x2E); // 0x2E é o comando para desativar o scroll. Garante que o scroll esteja desativado ao iniciar
-    ssd1306_WriteCommand(0x20); // Modo de endereçamento
-    ssd1306_WriteCommand(0x00); // 00 - Modo de endereçamento horizontal; 
-                                // 01 - Modo de endereçamento vertical;
-                                // 10 - Modo de endereçamento de página (RESET); 
-                                // 11 - Inválido
-
-    ssd1306_WriteCommand(0xB0); //Definir endereço inicial da página para o modo de endereçamento de página, 0-7
-
+// Sequência de configuração enviada por ssd1306_Init()
+static const uint8_t ssd1306_InitSequence[] = {
+    0xAE,       // Desliga o display temporariamente
+    0x2E,       // Desativa o scroll. Garante que o scroll esteja desativado ao iniciar
+    0x20, 0x00, // Modo de endereçamento: 00 - horizontal; 01 - vertical; 10 - página (RESET); 11 - inválido
+    0xB0,       // Endereço inicial da página para o modo de endereçamento de página, 0-7
 #ifdef SSD1306_MIRROR_VERT
-    ssd1306_WriteCommand(0xC0); // Mirror vertically
+    0xC0,       // Mirror vertically
 #else
-    ssd1306_WriteCommand(0xC8); //Set COM Output Scan Direction
+    0xC8,       // Set COM Output Scan Direction
 #endif
-
-    ssd1306_WriteCommand(0x00); //---set low column address
-    ssd1306_WriteCommand(0x10); //---set high column address
-
-    ssd1306_WriteCommand(0x40); //--set start line address - CHECK
-
-    ssd1306_SetContrast(0xFF);
-
+    0x00,       // Set low column address
+    0x10,       // Set high column address
+    0x40,       // Set start line address
+    0x81, 0xFF, // Contraste
 #ifdef SSD1306_MIRROR_HORIZ
-    ssd1306_WriteCommand(0xA0); // Mirror horizontally
+    0xA0,       // Mirror horizontally
 #else
-    ssd1306_WriteCommand(0xA1); //--set segment re-map 0 to 127 - CHECK
+    0xA1,       // Set segment re-map 0 to 127
 #endif
-
 #ifdef SSD1306_INVERSE_COLOR
-    ssd1306_WriteCommand(0xA7); //--set inverse color
+    0xA7,       // Set inverse color
 #else
-    ssd1306_WriteCommand(0xA6); //--set normal color
+    0xA6,       // Set normal color
 #endif
-
-// Set multiplex ratio.
+    // Set multiplex ratio
 #if (SSD1306_HEIGHT == 128)
-    // Found in the Luma Python lib for SH1106.
-    ssd1306_WriteCommand(0xFF);
+    0xFF,       // Found in the Luma Python lib for SH1106.
 #else
-    ssd1306_WriteCommand(0xA8); //--set multiplex ratio(1 to 64) - CHECK
+    0xA8,       // Set multiplex ratio(1 to 64)
 #endif
-
 #if (SSD1306_HEIGHT == 32)
-    ssd1306_WriteCommand(0x1F); //
+    0x1F,
 #elif (SSD1306_HEIGHT == 64)
-    ssd1306_WriteCommand(0x3F); //
+    0x3F,
 #elif (SSD1306_HEIGHT == 128)
-    ssd1306_WriteCommand(0x3F); // Seems to work for 128px high displays too.
+    0x3F,       // Seems to work for 128px high displays too.
 #else
 #error "Only 32, 64, or 128 lines of height are supported!"
 #endif
-
-    ssd1306_WriteCommand(0xA4); //0xa4,Output follows RAM content;0xa5,Output ignores RAM content
-
-    ssd1306_WriteCommand(0xD3); //-set display offset - CHECK
-    ssd1306_WriteCommand(0x00); //-not offset
-
-    ssd1306_WriteCommand(0xD5); //--set display clock divide ratio/oscillator frequency
-    ssd1306_WriteCommand(0xF0); //--set divide ratio
-
-    ssd1306_WriteCommand(0xD9); //--set pre-charge period
-    ssd1306_WriteCommand(0x22); //
-
-    ssd1306_WriteCommand(0xDA); //--set com pins hardware configuration - CHECK
+    0xA4,       // 0xA4: saída segue a RAM; 0xA5: saída ignora a RAM
+    0xD3, 0x00, // Display offset: sem deslocamento
+    0xD5, 0xF0, // Divisor do clock / frequência do oscilador
+    0xD9, 0x22, // Período de pré-carga
+    0xDA,       // Configuração dos pinos COM
 #if (SSD1306_HEIGHT == 32)
-    ssd1306_WriteCommand(0x02);
+    0x02,
 #elif (SSD1306_HEIGHT == 64)
-    ssd1306_WriteCommand(0x12);
+    0x12,
 #elif (SSD1306_HEIGHT == 128)
-    ssd1306_WriteCommand(0x12);
+    0x12,
 #else
 #error "Only 32, 64, or 128 lines of height are supported!"
 #endif
+    0xDB, 0x20, // VCOMH: 0.77 x Vcc
+    0x8D, 0x14, // Habilita o conversor DC-DC
+    0xAF,       // Liga o painel
+};
 
-    ssd1306_WriteCommand(0xDB); //--set vcomh
-    ssd1306_WriteCommand(0x20); //0x20,0.77xVcc
+/* Initialize the oled screen */
+void ssd1306_Init(void) { 
+    
+    sleep_ms(100); // Espera o display inicializar
+    i2c_init(i2c1, SSD1306_I2C_CLK * 1000); // Inicializa I2C
+    // Configura pinos
+    gpio_set_function(I2C_SDA_PIN, GPIO_FUNC_I2C); 
+    gpio_set_function(I2C_SCL_PIN, GPIO_FUNC_I2C);
+    // Habilita pull-ups
+    gpio_pull_up(I2C_SDA_PIN);
+    gpio_pull_up(I2C_SCL_PIN);
+    // Canal de DMA para a atualização assíncrona da tela
+    ssd1306_DmaInit();
 
-    ssd1306_WriteCommand(0x8D); //--set DC-DC enable
-    ssd1306_WriteCommand(0x14); //
-    ssd1306_SetDisplayOn(1); //--turn on SSD1306 panel
+    // Inicializa o display com a sequência de configuração em uma transação
+    ssd1306_WriteCommands(ssd1306_InitSequence, sizeof(ssd1306_InitSequence));
+    SSD1306.DisplayOn = 1;
 
     // Clear screen
     ssd1306_Fill(Black);
@@ -162,25 +327,203 @@ void ssd1306_Init(void) {
     SSD1306.Initialized = 1;
 }
 
+/**
+ * @brief Copia um quadro completo para o framebuffer, palavra por palavra.
+ * @param frame SSD1306_BUFFER_SIZE bytes, alinhado em 4 bytes.
+ */
+void ssd1306_LoadFrame(const uint32_t* frame) {
+    uint32_t *dst = (uint32_t *)SSD1306_Buffer;
+    for (uint32_t i = 0; i < SSD1306_BUFFER_SIZE / 4; i += 4) {
+        dst[i] = frame[i];
+        dst[i + 1] = frame[i + 1];
+        dst[i + 2] = frame[i + 2];
+        dst[i + 3] = frame[i + 3];
+    }
+}
+
+/**
+ * @brief Copia o framebuffer para um quadro, palavra por palavra.
+ * @param frame Destino com SSD1306_BUFFER_SIZE bytes, alinhado em 4 bytes.
+ */
+void ssd1306_SaveFrame(uint32_t* frame) {
+    const uint32_t *src = (const uint32_t *)SSD1306_Buffer;
+    for (uint32_t i = 0; i < SSD1306_BUFFER_SIZE / 4; i++) {
+        frame[i] = src[i];
+    }
+}
+
 /* Fill the whole screen with the given color */
 void ssd1306_Fill(SSD1306_COLOR color) {
-    memset(SSD1306_Buffer, (color == Black) ? 0x00 : 0xFF, sizeof(SSD1306_Buffer)); //Preenche o buffer de tela com 0x00 (preto) ou 0xFF (branco), dependendo da cor especificada.
+    memset(SSD1306_Buffer, (color == Black) ? 0x00 : 0xFF, SSD1306_BUFFER_SIZE); //Preenche o buffer de tela com 0x00 (preto) ou 0xFF (branco), dependendo da cor especificada.
+}
+
+/**
+ * @brief Marca o quadro inteiro para ser reenviado na próxima atualização.
+ *
+ * Necessário quando a RAM do display muda por fora do framebuffer
+ * (scroll por hardware, reset do display).
+ */
+void ssd1306_InvalidateScreen(void) {
+    SSD1306_ShadowValid = 0;
+}
+
+/*
+ * Compara o framebuffer com a cópia do último quadro enviado e monta as
+ * janelas alteradas. A cópia é atualizada, então as janelas devolvidas
+ * precisam ser enviadas.
+ * Retorna o número de janelas (no máximo uma por página).
+ */
+static uint8_t ssd1306_CollectDirty(SSD1306_Window_t *windows) {
+    uint8_t count = 0;
+
+    for (uint8_t page = 0; page < SSD1306_HEIGHT / 8; page++) {
+        const uint8_t *buf = &SSD1306_Buffer[page * SSD1306_WIDTH];
+        uint8_t *shadow = &SSD1306_Shadow[page * SSD1306_WIDTH];
+        uint32_t first = 0;
+        uint32_t last = SSD1306_WIDTH - 1;
+
+        if (SSD1306_ShadowValid) {
+            // Procura as primeiras e últimas palavras diferentes, depois refina por byte
+            const uint32_t *a = (const uint32_t *)buf;
+            const uint32_t *b = (const uint32_t *)shadow;
+            uint32_t lo = 0;
+            uint32_t hi = SSD1306_WIDTH / 4 - 1;
+            while (lo < SSD1306_WIDTH / 4 && a[lo] == b[lo]) {
+                lo++;
+            }
+            if (lo == SSD1306_WIDTH / 4) {
+                continue; // Página sem alterações
+            }
+            while (a[hi] == b[hi]) {
+                hi--;
+            }
+            first = lo * 4;
+            last = hi * 4 + 3;
+            while (buf[first] == shadow[first]) {
+                first++;
+            }
+            while (buf[last] == shadow[last]) {
+                last--;
+            }
+        }
+
+        uint16_t bytes = last - first + 1;
+        memcpy(&shadow[first], &buf[first], bytes);
+
+        // Estende a janela da página anterior se o desperdício for pequeno
+        if (count > 0) {
+            SSD1306_Window_t *w = &windows[count - 1];
+            if (w->p1 + 1 == page) {
+                uint8_t x0 = (first < w->x0) ? first : w->x0;
+                uint8_t x1 = (last > w->x1) ? last : w->x1;
+                uint32_t merged = (uint32_t)(x1 - x0 + 1) * (page - w->p0 + 1);
+                if (merged - (w->bytes + bytes) <= SSD1306_DIRTY_MERGE_SLACK) {
+                    w->x0 = x0;
+                    w->x1 = x1;
+                    w->p1 = page;
+                    w->bytes = merged;
+                    continue;
+                }
+            }
+        }
+
+        windows[count].x0 = first;
+        windows[count].x1 = last;
+        windows[count].p0 = page;
+        windows[count].p1 = page;
+        windows[count].bytes = bytes;
+        count++;
+    }
+
+    SSD1306_ShadowValid = 1;
+    return count;
 }
 
 /* Write the screenbuffer with changed to the screen */
 void ssd1306_UpdateScreen(void) {
-    // Write data to each page of RAM. Number of pages
-    // depends on the screen height:
-    //
-    //  * 32px   ==  4 pages
-    //  * 64px   ==  8 pages
-    //  * 128px  ==  16 pages
-    for(uint8_t i = 0; i < SSD1306_HEIGHT/8; i++) {  //Itera sobre cada página (bloco de 8 pixels de altura).
-        ssd1306_WriteCommand(0xB0 + i); // Define a página atual. (RAM page address).
-        ssd1306_WriteCommand(0x00 + SSD1306_X_OFFSET_LOWER); // Define a coluna inicial.
-        ssd1306_WriteCommand(0x10 + SSD1306_X_OFFSET_UPPER); // Define a coluna final.
-        ssd1306_WriteData(&SSD1306_Buffer[SSD1306_WIDTH*i],SSD1306_WIDTH); //Envia os dados da página atual para o display.
+    // Só as janelas que mudaram desde o último quadro são enviadas.
+    // O modo horizontal percorre a janela coluna a coluna e página a
+    // página, e o ponteiro continua entre transações de dados.
+    PROBE_BEGIN(PROBE_SSD1306_UPDATE);
+    SSD1306_Window_t windows[SSD1306_HEIGHT / 8];
+    uint8_t count = ssd1306_CollectDirty(windows);
+    const uint8_t column = SSD1306_X_OFFSET_LOWER | (SSD1306_X_OFFSET_UPPER << 4);
+
+    for (uint8_t i = 0; i < count; i++) {
+        const SSD1306_Window_t *w = &windows[i];
+        const uint8_t window[] = {
+            0x21, column + w->x0, column + w->x1, // Faixa de colunas
+            0x22, w->p0, w->p1,                   // Faixa de páginas
+        };
+        ssd1306_WriteCommands(window, sizeof(window));
+
+        uint16_t width = w->x1 - w->x0 + 1;
+        if (width == SSD1306_WIDTH) {
+            // Páginas inteiras são contíguas no framebuffer: uma transação só
+            ssd1306_WriteFrameData(&SSD1306_Buffer[w->p0 * SSD1306_WIDTH], (w->p1 - w->p0 + 1) * SSD1306_WIDTH);
+        } else {
+            for (uint8_t page = w->p0; page <= w->p1; page++) {
+                ssd1306_WriteFrameData(&SSD1306_Buffer[page * SSD1306_WIDTH + w->x0], width);
+            }
+        }
     }
+    PROBE_END(PROBE_SSD1306_UPDATE);
+}
+
+/**
+ * @brief Envia o framebuffer para a tela por DMA, sem bloquear a CPU.
+ *
+ * As janelas alteradas são copiadas para o buffer de transmissão, então o
+ * desenho do próximo quadro pode começar logo em seguida. Só bloqueia se o
+ * quadro anterior ainda estiver sendo transmitido.
+ */
+void ssd1306_UpdateScreenAsync(void) {
+    ssd1306_FlushCommands(); // Comandos pendentes vêm antes do quadro
+    ssd1306_WaitForFlush();
+
+    PROBE_BEGIN(PROBE_SSD1306_UPDATE_ASYNC);
+    SSD1306_Window_t windows[SSD1306_HEIGHT / 8];
+    uint8_t count = ssd1306_CollectDirty(windows);
+    if (count == 0) {
+        PROBE_END(PROBE_SSD1306_UPDATE_ASYNC);
+        return; // Nada mudou desde o último quadro
+    }
+
+    const uint8_t column = SSD1306_X_OFFSET_LOWER | (SSD1306_X_OFFSET_UPPER << 4);
+    uint16_t *tx = SSD1306_TxBuffer;
+
+    for (uint8_t i = 0; i < count; i++) {
+        const SSD1306_Window_t *w = &windows[i];
+
+        // Transação de comandos: janela de colunas e páginas (modo horizontal)
+        *tx++ = 0x00;
+        *tx++ = 0x21;
+        *tx++ = column + w->x0;
+        *tx++ = column + w->x1;
+        *tx++ = 0x22;
+        *tx++ = w->p0;
+        *tx++ = w->p1 | I2C_IC_DATA_CMD_STOP_BITS;
+
+        // Transação de dados: o conteúdo da janela em uma transação só
+        *tx++ = 0x40;
+        for (uint8_t page = w->p0; page <= w->p1; page++) {
+            const uint8_t *src = &SSD1306_Buffer[page * SSD1306_WIDTH];
+            for (uint32_t x = w->x0; x <= w->x1; x++) {
+                *tx++ = src[x];
+            }
+        }
+        tx[-1] |= I2C_IC_DATA_CMD_STOP_BITS;
+    }
+    ssd1306_tx_bytes += tx - SSD1306_TxBuffer;
+
+    // Endereço do display (só pode ser alterado com o controlador desabilitado)
+    i2c_hw_t *hw = i2c_get_hw(SSD1306_I2C_PORT);
+    hw->enable = 0;
+    hw->tar = SSD1306_I2C_ADDR;
+    hw->enable = 1;
+
+    dma_channel_transfer_from_buffer_now(ssd1306_dma_chan, SSD1306_TxBuffer, tx - SSD1306_TxBuffer);
+    PROBE_END(PROBE_SSD1306_UPDATE_ASYNC);
 }
 
 /*
@@ -203,6 +546,68 @@ void ssd1306_DrawPixel(uint8_t x, uint8_t y, SSD1306_COLOR color) {
     }
 }
 
+/*
+ * Copia faixas de página para o framebuffer, com fundo: strips tem
+ * (h + 7) / 8 faixas de w bytes, bit 0 = linha de cima. Quando y não é
+ * múltiplo de 8, cada byte se divide entre duas páginas do framebuffer.
+ * A área precisa caber na tela.
+ */
+static void ssd1306_BlitPages(uint8_t x, uint8_t y, const uint8_t *strips, uint8_t w, uint8_t h, SSD1306_COLOR color) {
+    uint8_t shift = y % 8;
+    uint8_t invert = (color == White) ? 0x00 : 0xFF;
+    uint8_t *row = &SSD1306_Buffer[(y / 8) * SSD1306_WIDTH + x];
+
+    for (uint8_t top = 0; top < h; top += 8, strips += w, row += SSD1306_WIDTH) {
+        uint8_t mask = (h - top >= 8) ? 0xFF : (0xFF >> (8 - (h - top)));
+        uint8_t low_mask = mask << shift;
+        uint8_t high_mask = shift ? mask >> (8 - shift) : 0;
+
+        for (uint8_t j = 0; j < w; j++) {
+            uint8_t bits = strips[j] ^ invert;
+            row[j] = (row[j] & ~low_mask) | ((uint8_t)(bits << shift) & low_mask);
+            if (high_mask) {
+                row[j + SSD1306_WIDTH] = (row[j + SSD1306_WIDTH] & ~high_mask) | ((bits >> (8 - shift)) & high_mask);
+            }
+        }
+    }
+}
+
+/*
+ * Desenha um glifo em linhas de 16 bits (bit 15 = coluna 0), com fundo.
+ * Caminho das fontes sem faixas de página.
+ */
+static void ssd1306_BlitRows(uint8_t x, uint8_t y, const uint16_t *glyph, uint8_t width, uint8_t height, SSD1306_COLOR color) {
+    uint32_t i, b, j;
+
+    // Transpõe o glifo (linhas de 16 bits, MSB à esquerda) para colunas
+    uint32_t columns[16] = {0};
+    for(i = 0; i < height; i++) {
+        b = glyph[i];
+        for(j = 0; b & 0xFFFF; j++, b <<= 1) {
+            if(b & 0x8000) {
+                columns[j] |= 1u << i;
+            }
+        }
+    }
+
+    // Grava cada coluna nas páginas que ela cobre; o fundo recebe a cor oposta
+    uint8_t shift = y % 8;
+    uint8_t pages = (shift + height + 7) / 8;
+    uint64_t area = ((((uint64_t)1) << height) - 1) << shift;
+    uint8_t *column_start = &SSD1306_Buffer[(y / 8) * SSD1306_WIDTH + x];
+    for(j = 0; j < width; j++) {
+        uint64_t bits = ((uint64_t)columns[j]) << shift;
+        if(color == Black) {
+            bits = ~bits & area;
+        }
+        uint8_t *dst = column_start + j;
+        for(uint32_t p = 0; p < pages; p++, dst += SSD1306_WIDTH) {
+            uint8_t mask = (uint8_t)(area >> (8 * p));
+            *dst = (*dst & ~mask) | ((uint8_t)(bits >> (8 * p)) & mask);
+        }
+    }
+}
+
 /*
  * Draw 1 char to the screen buffer
  * ch       => char om weg te schrijven
@@ -210,8 +615,6 @@ void ssd1306_DrawPixel(uint8_t x, uint8_t y, SSD1306_COLOR color) {
  * color    => Black or White
  */
 char ssd1306_WriteChar(char ch, SSD1306_Font_t Font, SSD1306_COLOR color) {
-    uint32_t i, b, j;
-    
     // Check if character is valid
     if (ch < 32 || ch > 126) 
         return 0;
@@ -224,16 +627,14 @@ char ssd1306_WriteChar(char ch, SSD1306_Font_t Font, SSD1306_COLOR color) {
         return 0;
     }
     
-    // Use the font to write
-    for(i = 0; i < Font.height; i++) {
-        b = Font.data[(ch - 32) * Font.height + i];
-        for(j = 0; j < Font.width; j++) {
-            if((b << j) & 0x8000)  {
-                ssd1306_DrawPixel(SSD1306.CurrentX + j, (SSD1306.CurrentY + i), (SSD1306_COLOR) color);
-            } else {
-                ssd1306_DrawPixel(SSD1306.CurrentX + j, (SSD1306.CurrentY + i), (SSD1306_COLOR)!color);
-            }
-        }
+    if(Font.pages) {
+        // Glifo já em faixas de página: bytes inteiros para o framebuffer.
+        // Fontes reduzidas na compilação guardam só alguns glifos.
+        uint32_t glyph = Font.remap ? Font.remap[ch - 32] : (uint32_t)(ch - 32);
+        uint32_t glyph_bytes = ((Font.height + 7) / 8) * Font.width;
+        ssd1306_BlitPages(SSD1306.CurrentX, SSD1306.CurrentY, &Font.pages[glyph * glyph_bytes], Font.width, Font.height, color);
+    } else {
+        ssd1306_BlitRows(SSD1306.CurrentX, SSD1306.CurrentY, &Font.data[(ch - 32) * Font.height], Font.width, Font.height, color);
     }
     
     // The current space is now taken
@@ -271,6 +672,12 @@ void ssd1306_Line(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR
     int32_t signY = ((y1 < y2) ? 1 : -1);
     int32_t error = deltaX - deltaY;
     int32_t error2;
+
+    // Linhas verticais e horizontais (eixos e barras do gráfico) viram spans
+    if(x1 == x2 || y1 == y2) {
+        ssd1306_FillRectangle(x1, y1, x2, y2, color);
+        return;
+    }
     
     ssd1306_DrawPixel(x2, y2, color);
 
@@ -489,6 +896,41 @@ void ssd1306_DrawRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD13
     return;
 }
 
+/* Fill len bytes with value, using 32-bit stores on the aligned middle part */
+static void ssd1306_FillBytes(uint8_t *dst, uint8_t value, uint32_t len) {
+    while (len > 0 && ((uintptr_t)dst & 3)) {
+        *dst++ = value;
+        len--;
+    }
+    uint32_t word = value * 0x01010101u;
+    uint32_t *dst32 = (uint32_t *)dst;
+    for (; len >= 4; len -= 4) {
+        *dst32++ = word;
+    }
+    dst = (uint8_t *)dst32;
+    while (len--) {
+        *dst++ = value;
+    }
+}
+
+/* Apply a page-byte mask to columns x0..x1 of one page */
+static void ssd1306_FillPageSpan(uint8_t page, uint8_t x0, uint8_t x1, uint8_t mask, SSD1306_COLOR color) {
+    uint8_t *dst = &SSD1306_Buffer[page * SSD1306_WIDTH + x0];
+    uint32_t len = x1 - x0 + 1;
+    if (mask == 0xFF) {
+        ssd1306_FillBytes(dst, (color == White) ? 0xFF : 0x00, len);
+    } else if (color == White) {
+        while (len--) {
+            *dst++ |= mask;
+        }
+    } else {
+        mask = ~mask;
+        while (len--) {
+            *dst++ &= mask;
+        }
+    }
+}
+
 /* Draw a filled rectangle */
 void ssd1306_FillRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color) {
     uint8_t x_start = ((x1<=x2) ? x1 : x2);
@@ -496,12 +938,80 @@ void ssd1306_FillRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD13
     uint8_t y_start = ((y1<=y2) ? y1 : y2);
     uint8_t y_end   = ((y1<=y2) ? y2 : y1);
 
-    for (uint8_t y= y_start; (y<= y_end)&&(y<SSD1306_HEIGHT); y++) {
-        for (uint8_t x= x_start; (x<= x_end)&&(x<SSD1306_WIDTH); x++) {
-            ssd1306_DrawPixel(x, y, color);
+    if (x_start >= SSD1306_WIDTH || y_start >= SSD1306_HEIGHT) {
+        return;
+    }
+    if (x_end >= SSD1306_WIDTH) {
+        x_end = SSD1306_WIDTH - 1;
+    }
+    if (y_end >= SSD1306_HEIGHT) {
+        y_end = SSD1306_HEIGHT - 1;
+    }
+
+    // Cada página recebe uma máscara: parcial nas bordas, 0xFF no meio
+    uint8_t first_page = y_start / 8;
+    uint8_t last_page = y_end / 8;
+    if (first_page == last_page) {
+        ssd1306_FillPageSpan(first_page, x_start, x_end, (0xFF << (y_start % 8)) & (0xFF >> (7 - (y_end % 8))), color);
+        return;
+    }
+
+    ssd1306_FillPageSpan(first_page, x_start, x_end, 0xFF << (y_start % 8), color);
+    if (x_start == 0 && x_end == SSD1306_WIDTH - 1) {
+        // Páginas inteiras são contíguas: um único preenchimento por palavras
+        ssd1306_FillBytes(&SSD1306_Buffer[(first_page + 1) * SSD1306_WIDTH], (color == White) ? 0xFF : 0x00,
+                          (last_page - first_page - 1) * SSD1306_WIDTH);
+    } else {
+        for (uint8_t page = first_page + 1; page < last_page; page++) {
+            ssd1306_FillPageSpan(page, x_start, x_end, 0xFF, color);
         }
     }
-    return;
+    ssd1306_FillPageSpan(last_page, x_start, x_end, 0xFF >> (7 - (y_end % 8)), color);
+}
+
+/**
+ * @brief Desloca as linhas y1..y2 do framebuffer dx colunas para a esquerda.
+ *
+ * As colunas que entram pela direita ficam apagadas; o resto das páginas
+ * de borda é preservado pela máscara. Usado por gráficos que rolam.
+ */
+void ssd1306_ShiftLeft(uint8_t y1, uint8_t y2, uint8_t dx) {
+    if (y1 > y2 || y1 >= SSD1306_HEIGHT) {
+        return;
+    }
+    if (y2 >= SSD1306_HEIGHT) {
+        y2 = SSD1306_HEIGHT - 1;
+    }
+    if (dx >= SSD1306_WIDTH) {
+        ssd1306_FillRectangle(0, y1, SSD1306_WIDTH - 1, y2, Black);
+        return;
+    }
+    if (dx == 0) {
+        return;
+    }
+
+    uint8_t last_page = y2 / 8;
+    for (uint8_t page = y1 / 8; page <= last_page; page++) {
+        uint8_t mask = 0xFF;
+        if (page == y1 / 8) {
+            mask &= 0xFF << (y1 % 8);
+        }
+        if (page == last_page) {
+            mask &= 0xFF >> (7 - (y2 % 8));
+        }
+
+        uint8_t *row = &SSD1306_Buffer[page * SSD1306_WIDTH];
+        uint32_t len = SSD1306_WIDTH - dx;
+        if (mask == 0xFF) {
+            memmove(row, row + dx, len);
+        } else {
+            uint8_t keep = ~mask;
+            for (uint32_t x = 0; x < len; x++) {
+                row[x] = (row[x] & keep) | (row[x + dx] & mask);
+            }
+        }
+        ssd1306_FillPageSpan(page, len, SSD1306_WIDTH - 1, mask, Black);
+    }
 }
 
 SSD1306_Error_t ssd1306_InvertRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2) {
@@ -537,22 +1047,34 @@ SSD1306_Error_t ssd1306_InvertRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint
 /* Draw a bitmap */
 void ssd1306_DrawBitmap(uint8_t x, uint8_t y, const unsigned char* bitmap, uint8_t w, uint8_t h, SSD1306_COLOR color) {
     int16_t byteWidth = (w + 7) / 8; // Bitmap scanline pad = whole byte
-    uint8_t byte = 0;
 
     if (x >= SSD1306_WIDTH || y >= SSD1306_HEIGHT) {
         return;
     }
 
-    for (uint8_t j = 0; j < h; j++, y++) {
-        for (uint8_t i = 0; i < w; i++) {
-            if (i & 7) {
-                byte <<= 1;
-            } else {
-                byte = (*(const unsigned char *)(&bitmap[j * byteWidth + i / 8]));
-            }
+    // Recorta uma vez, em vez de testar cada pixel
+    uint8_t visible_w = (x + w > SSD1306_WIDTH) ? SSD1306_WIDTH - x : w;
+    uint8_t visible_h = (y + h > SSD1306_HEIGHT) ? SSD1306_HEIGHT - y : h;
 
-            if (byte & 0x80) {
-                ssd1306_DrawPixel(x + i, y, color);
+    for (uint8_t j = 0; j < visible_h; j++, y++) {
+        const unsigned char *row = &bitmap[j * byteWidth];
+        uint8_t *dst = &SSD1306_Buffer[(y / 8) * SSD1306_WIDTH + x];
+        uint8_t bit = 1 << (y % 8);
+
+        for (uint8_t i = 0; i < visible_w; i += 8) {
+            uint8_t byte = row[i / 8];
+            if (byte == 0) {
+                continue; // 8 pixels transparentes de uma vez
+            }
+            uint8_t count = (visible_w - i < 8) ? visible_w - i : 8;
+            for (uint8_t k = 0; k < count; k++, byte <<= 1) {
+                if (byte & 0x80) {
+                    if (color == White) {
+                        dst[i + k] |= bit;
+                    } else {
+                        dst[i + k] &= ~bit;
+                    }
+                }
             }
         }
     }
@@ -561,8 +1083,8 @@ void ssd1306_DrawBitmap(uint8_t x, uint8_t y, const unsigned char* bitmap, uint8
 
 void ssd1306_SetContrast(const uint8_t value) {
     const uint8_t kSetContrastControlRegister = 0x81;
-    ssd1306_WriteCommand(kSetContrastControlRegister);
-    ssd1306_WriteCommand(value);
+    const uint8_t cmds[] = { kSetContrastControlRegister, value };
+    ssd1306_WriteCommands(cmds, sizeof(cmds));
 }
 
 void ssd1306_SetDisplayOn(const uint8_t on) {
@@ -592,14 +1114,17 @@ uint8_t ssd1306_GetDisplayOn() {
  * @param scrollSpeed Velocidade do scroll (0 a 7, onde 0 é o mais rápido)
  */
 void ssd1306_StartScrollRight(uint8_t startPage, uint8_t endPage, uint8_t scrollSpeed) {
-    ssd1306_WriteCommand(0x26);              // Comando para scroll horizontal à direita
-    ssd1306_WriteCommand(0x00);              // Byte dummy
-    ssd1306_WriteCommand(startPage & 0x07);    // Página de início
-    ssd1306_WriteCommand(scrollSpeed & 0x07);  // Intervalo de tempo
-    ssd1306_WriteCommand(endPage & 0x07);      // Página final
-    ssd1306_WriteCommand(0x00);              // Byte dummy
-    ssd1306_WriteCommand(0xFF);              // Byte dummy
-    ssd1306_WriteCommand(0x2F);              // Ativa o scroll
+    const uint8_t cmds[] = {
+        0x26,                // Comando para scroll horizontal à direita
+        0x00,                // Byte dummy
+        startPage & 0x07,    // Página de início
+        scrollSpeed & 0x07,  // Intervalo de tempo
+        endPage & 0x07,      // Página final
+        0x00,                // Byte dummy
+        0xFF,                // Byte dummy
+        0x2F,                // Ativa o scroll
+    };
+    ssd1306_WriteCommands(cmds, sizeof(cmds));
 }
 
 /**
@@ -609,14 +1134,17 @@ void ssd1306_StartScrollRight(uint8_t startPage, uint8_t endPage, uint8_t scroll
  * @param scrollSpeed Velocidade do scroll (0 a 7, onde 0 é o mais rápido)
  */
 void ssd1306_StartScrollLeft(uint8_t startPage, uint8_t endPage, uint8_t scrollSpeed) {
-    ssd1306_WriteCommand(0x27);              // Comando para scroll horizontal à esquerda
-    ssd1306_WriteCommand(0x00);              // Byte dummy
-    ssd1306_WriteCommand(startPage & 0x07);    // Página de início
-    ssd1306_WriteCommand(scrollSpeed & 0x07);  // Intervalo de tempo
-    ssd1306_WriteCommand(endPage & 0x07);      // Página final
-    ssd1306_WriteCommand(0x00);              // Byte dummy
-    ssd1306_WriteCommand(0xFF);              // Byte dummy
-    ssd1306_WriteCommand(0x2F);              // Ativa o scroll
+    const uint8_t cmds[] = {
+        0x27,                // Comando para scroll horizontal à esquerda
+        0x00,                // Byte dummy
+        startPage & 0x07,    // Página de início
+        scrollSpeed & 0x07,  // Intervalo de tempo
+        endPage & 0x07,      // Página final
+        0x00,                // Byte dummy
+        0xFF,                // Byte dummy
+        0x2F,                // Ativa o scroll
+    };
+    ssd1306_WriteCommands(cmds, sizeof(cmds));
 }
 
 /**
@@ -624,6 +1152,7 @@ void ssd1306_StartScrollLeft(uint8_t startPage, uint8_t endPage, uint8_t scrollS
  */
 void ssd1306_StopScroll(void) {
     ssd1306_WriteCommand(0x2E); // Desativa o scroll
+    ssd1306_InvalidateScreen(); // O scroll por hardware deslocou a RAM do display
 }
 
 /**
@@ -75,12 +75,31 @@ typedef struct {
 	const uint8_t height;               /**< Font height in pixels */
 	const uint16_t *const data;         /**< Pointer to font data array */
     const uint8_t *const char_width;    /**< Proportional character width in pixels (NULL for monospaced) */
+    const uint8_t *const pages;         /**< Glifos em faixas de página, gerados por tools/font_pages.py (NULL usa data) */
+    const uint8_t *const remap;         /**< Índice do glifo em pages por caractere - 32 (NULL: todos os glifos) */
 } SSD1306_Font_t;
 
+/** Callback chamado quando o DMA termina de entregar um quadro */
+typedef void (*SSD1306_FlushCallback_t)(void);
+
 // Procedure definitions
 void ssd1306_Init(void);
 void ssd1306_Fill(SSD1306_COLOR color);
 void ssd1306_UpdateScreen(void);
+
+// Atualização assíncrona (DMA -> FIFO do I2C)
+void ssd1306_UpdateScreenAsync(void);
+uint8_t ssd1306_IsBusy(void);
+void ssd1306_WaitForFlush(void);
+void ssd1306_SetFlushCallback(SSD1306_FlushCallback_t callback);
+
+// Camadas: quadros completos copiados de/para o framebuffer por palavras
+void ssd1306_LoadFrame(const uint32_t* frame);
+void ssd1306_SaveFrame(uint32_t* frame);
+
+// Atualização parcial: só as janelas alteradas desde o último quadro são enviadas
+void ssd1306_InvalidateScreen(void);
+uint32_t ssd1306_GetTxByteCount(void);
 void ssd1306_DrawPixel(uint8_t x, uint8_t y, SSD1306_COLOR color);
 char ssd1306_WriteChar(char ch, SSD1306_Font_t Font, SSD1306_COLOR color);
 char ssd1306_WriteString(char* str, SSD1306_Font_t Font, SSD1306_COLOR color);
@@ -93,6 +112,7 @@ void ssd1306_FillCircle(uint8_t par_x,uint8_t par_y,uint8_t par_r,SSD1306_COLOR
 void ssd1306_Polyline(const SSD1306_VERTEX *par_vertex, uint16_t par_size, SSD1306_COLOR color);
 void ssd1306_DrawRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color);
 void ssd1306_FillRectangle(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2, SSD1306_COLOR color);
+void ssd1306_ShiftLeft(uint8_t y1, uint8_t y2, uint8_t dx);
 
 /**
  * @brief Invert color of pixels in rectangle (include border)
@@ -130,6 +150,9 @@ uint8_t ssd1306_GetDisplayOn();
 
 // Low-level procedures
 void ssd1306_WriteCommand(uint8_t byte);
+void ssd1306_WriteCommands(const uint8_t* cmds, size_t count);
+void ssd1306_BeginCommands(void);
+void ssd1306_EndCommands(void);
 void ssd1306_WriteData(uint8_t* buffer, size_t buff_size);
 SSD1306_Error_t ssd1306_FillBuffer(uint8_t* buf, uint32_t len);
 
@@ -895,21 +895,21 @@ static const uint8_t char_width[] = {
 #endif
 
 #ifdef SSD1306_INCLUDE_FONT_6x8
-const SSD1306_Font_t Font_6x8 = {6, 8, Font6x8, NULL};
+const SSD1306_Font_t Font_6x8 = {6, 8, Font6x8, NULL, NULL, NULL};
 #endif
 #ifdef SSD1306_INCLUDE_FONT_7x10
-const SSD1306_Font_t Font_7x10 = {7, 10, Font7x10, NULL};
+const SSD1306_Font_t Font_7x10 = {7, 10, Font7x10, NULL, NULL, NULL};
 #endif
 #ifdef SSD1306_INCLUDE_FONT_11x18
-const SSD1306_Font_t Font_11x18 = {11, 18, Font11x18, NULL};
+const SSD1306_Font_t Font_11x18 = {11, 18, Font11x18, NULL, NULL, NULL};
 #endif
 #ifdef SSD1306_INCLUDE_FONT_16x26
-const SSD1306_Font_t Font_16x26 = {16, 26, Font16x26, NULL};
+const SSD1306_Font_t Font_16x26 = {16, 26, Font16x26, NULL, NULL, NULL};
 #endif
 
 /* see ./examples/custom-fonts/ */
 #ifdef SSD1306_INCLUDE_FONT_16x24
-const SSD1306_Font_t Font_16x24 = {16, 24, Font16x24, NULL};
+const SSD1306_Font_t Font_16x24 = {16, 24, Font16x24, NULL, NULL, NULL};
 #endif
 
 #ifdef SSD1306_INCLUDE_FONT_16x15
@@ -917,6 +917,6 @@ const SSD1306_Font_t Font_16x24 = {16, 24, Font16x24, NULL};
  * @copyright Google https://github.com/googlefonts/roboto
  * @license This font is licensed under the Apache License, Version 2.0.
 */
-const SSD1306_Font_t Font_16x15 = {16, 15, Font16x15, char_width};
+const SSD1306_Font_t Font_16x15 = {16, 15, Font16x15, char_width, NULL, NULL};
 #endif
 
@@ -1,9 +1,52 @@
 #include "mic.h"
 #include "pico/stdlib.h"
 #include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "inc/probe.h"
+#include "inc/fixed_point.h"
 #include <math.h>
+#include <string.h>
 
-static uint16_t adc_buffer[SAMPLES];
+static uint16_t adc_buffer[SAMPLES] __attribute__((aligned(4)));
+static MicBlockStats adc_stats;     // Estatísticas do bloco em adc_buffer
+static uint16_t zc_reference = MIC_ZC_REFERENCE_DEFAULT; // DC do bloco anterior, referência dos cruzamentos
+
+// Buffers ping-pong preenchidos pelo DMA. Cada canal escreve sempre no mesmo
+// buffer e, ao terminar, dispara o outro canal (chain), então não há intervalo
+// entre blocos consecutivos.
+static uint16_t capture_buffers[2][SAMPLES] __attribute__((aligned(4)));
+static int dma_chan[2] = {-1, -1};
+
+static mic_block_callback_t block_callback = NULL;
+static volatile bool capturing = false;
+static volatile uint32_t block_count = 0;   // Blocos completos desde o início da captura
+static volatile uint8_t last_block = 0;     // Índice do último buffer completo
+static uint32_t consumed_count = 0;         // Último bloco entregue por mic_sample()
+static uint32_t dropped_blocks = 0;         // Blocos que mic_sample() não chegou a ler
+
+// Trata o fim de um bloco: rearma o canal e avisa o consumidor
+static void mic_dma_irq_handler() {
+    for (uint8_t i = 0; i < 2; i++) {
+        if (dma_chan[i] < 0 || !dma_channel_get_irq0_status(dma_chan[i])) {
+            continue;
+        }
+        dma_channel_acknowledge_irq0(dma_chan[i]);
+
+        // O contador de transferências é recarregado sozinho; basta voltar o
+        // endereço de escrita para o início do buffer. O canal fica parado até
+        // ser disparado pelo fim do outro canal.
+        dma_channel_set_write_addr(dma_chan[i], capture_buffers[i], false);
+
+        last_block = i;
+        block_count++;
+
+        if (block_callback) {
+            block_callback(capture_buffers[i], SAMPLES);
+        }
+    }
+}
 
 // Inicializa o ADC para leitura do microfone
 void mic_init() {
@@ -13,25 +56,203 @@ void mic_init() {
     adc_set_clkdiv(ADC_CLOCK_DIV);
 }
 
-// Realiza leituras do ADC e armazena no buffer
+// Inicia a captura contínua do ADC via DMA
+void mic_start_capture(mic_block_callback_t callback) {
+    if (capturing) {
+        mic_stop_capture();
+    }
+
+    block_callback = callback;
+    block_count = 0;
+    consumed_count = 0;
+    dropped_blocks = 0;
+
+    // FIFO habilitada, DREQ a cada amostra, sem bit de erro e sem deslocamento (12 bits)
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_fifo_drain();
+
+    if (dma_chan[0] < 0) {
+        dma_chan[0] = dma_claim_unused_channel(true);
+        dma_chan[1] = dma_claim_unused_channel(true);
+        irq_add_shared_handler(DMA_IRQ_0, mic_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+        irq_set_enabled(DMA_IRQ_0, true);
+    }
+
+    for (uint8_t i = 0; i < 2; i++) {
+        dma_channel_config cfg = dma_channel_get_default_config(dma_chan[i]);
+        channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+        channel_config_set_read_increment(&cfg, false);
+        channel_config_set_write_increment(&cfg, true);
+        channel_config_set_dreq(&cfg, DREQ_ADC);
+        channel_config_set_chain_to(&cfg, dma_chan[i ^ 1]);
+
+        dma_channel_configure(dma_chan[i], &cfg, capture_buffers[i], &adc_hw->fifo, SAMPLES, false);
+        dma_channel_set_irq0_enabled(dma_chan[i], true);
+    }
+
+    capturing = true;
+    dma_channel_start(dma_chan[0]);
+    adc_run(true);
+}
+
+// Interrompe a captura contínua
+void mic_stop_capture() {
+    if (!capturing) {
+        return;
+    }
+
+    adc_run(false);
+    for (uint8_t i = 0; i < 2; i++) {
+        dma_channel_set_irq0_enabled(dma_chan[i], false);
+    }
+
+    // Aborta os dois canais juntos: abortar um de cada vez dispararia o outro pelo chain
+    dma_hw->abort = (1u << dma_chan[0]) | (1u << dma_chan[1]);
+    while (dma_hw->abort) {
+        tight_loop_contents();
+    }
+    dma_channel_acknowledge_irq0(dma_chan[0]);
+    dma_channel_acknowledge_irq0(dma_chan[1]);
+    adc_fifo_setup(false, false, 0, false, false);
+    adc_fifo_drain();
+
+    capturing = false;
+    block_callback = NULL;
+}
+
+bool mic_is_capturing() {
+    return capturing;
+}
+
+uint32_t mic_get_block_count() {
+    return block_count;
+}
+
+uint32_t mic_get_dropped_blocks() {
+    return dropped_blocks;
+}
+
+// Aguarda o próximo bloco completo e o copia para o buffer de análise
 void mic_sample() {
-    for (int i = 0; i < SAMPLES; i++) {
-        adc_buffer[i] = adc_read();
+    if (!capturing) {
+        mic_start_capture(NULL);
+    }
+
+    // Dorme até a interrupção do DMA; a entrada na interrupção liga o registrador
+    // de evento, então um bloco que chega antes do __wfe não é perdido
+    while (block_count == consumed_count) {
+        __wfe();
     }
+
+    // O DMA só volta a escrever neste buffer depois que o outro encher,
+    // o que dá um bloco inteiro de folga para a cópia.
+    PROBE_BEGIN(PROBE_MIC_SAMPLE);
+    uint32_t count = block_count;
+    memcpy(adc_buffer, capture_buffers[last_block], sizeof(adc_buffer));
+
+    dropped_blocks += count - consumed_count - 1;
+    consumed_count = count;
+
+    // Uma única passada sobre o bloco atende todas as consultas seguintes
+    mic_block_stats(adc_buffer, SAMPLES, zc_reference, &adc_stats);
+
+    // O próximo bloco conta cruzamentos em torno do DC deste
+    zc_reference = adc_stats.dc_mean;
+    PROBE_END(PROBE_MIC_SAMPLE);
 }
 
-// Calcula a potência média (RMS) das amostras
-float mic_get_rms() {
-    float avg = 0.f;
-    for (uint i = 0; i < SAMPLES; i++) {
-        avg += adc_buffer[i] * adc_buffer[i];
+// Acumula uma amostra: extremos, saturação e cruzamentos do nível de referência
+#define MIC_STATS_ACCUMULATE(x)                                            \
+    do {                                                                   \
+        uint32_t s_ = (x);                                                 \
+        sum += s_;                                                         \
+        chunk_sq += s_ * s_;                                               \
+        if (s_ < min) min = s_;                                            \
+        if (s_ > max) max = s_;                                            \
+        saturated += (s_ <= MIC_SATURATION_MARGIN) |                       \
+                     (s_ >= MIC_ADC_MAX - MIC_SATURATION_MARGIN);          \
+        uint32_t above_ = (s_ >= ref);                                     \
+        crossings += above_ ^ prev_above;                                  \
+        prev_above = above_;                                               \
+    } while (0)
+
+// Calcula todas as estatísticas do bloco em uma passada, com acumuladores inteiros.
+// Lê duas amostras de 12 bits por palavra de 32 bits; o bloco deve estar alinhado em 4 bytes.
+void mic_block_stats(const uint16_t *block, uint32_t count, uint16_t reference, MicBlockStats *stats) {
+    const uint32_t *words = (const uint32_t *)block;
+    const uint32_t ref = reference;
+    uint32_t pairs = count >> 1;
+    uint32_t sum = 0;
+    uint64_t sum_sq = 0;
+    uint32_t min = MIC_ADC_MAX;
+    uint32_t max = 0;
+    uint32_t saturated = 0;
+    uint32_t crossings = 0;
+    uint32_t prev_above = (count > 0) && (block[0] >= ref);
+
+    while (pairs) {
+        // 64 pares de 4095^2 ainda cabem em 32 bits; só o total vai para 64 bits
+        uint32_t chunk = pairs > 64 ? 64 : pairs;
+        uint32_t chunk_sq = 0;
+        pairs -= chunk;
+
+        while (chunk--) {
+            uint32_t w = *words++;
+            MIC_STATS_ACCUMULATE(w & 0xFFFFu);
+            MIC_STATS_ACCUMULATE(w >> 16);
+        }
+        sum_sq += chunk_sq;
+    }
+
+    if (count & 1u) {
+        uint32_t chunk_sq = 0;
+        MIC_STATS_ACCUMULATE(block[count - 1]);
+        sum_sq += chunk_sq;
     }
-    avg /= SAMPLES;
-    return sqrtf(avg);
+
+    stats->count = count;
+    stats->min = min;
+    stats->max = max;
+    stats->saturated = saturated;
+    stats->zero_crossings = crossings;
+
+    if (count == 0) {
+        stats->dc_mean = 0;
+        stats->ac_power = 0;
+        stats->ac_rms = 0;
+        stats->peak = 0;
+        return;
+    }
+
+    // Variância = (n * soma(x^2) - soma(x)^2) / n^2, sem perder precisão com a média
+    uint32_t mean = (sum + count / 2) / count;
+    uint64_t spread = (uint64_t)count * sum_sq - (uint64_t)sum * sum;
+    stats->dc_mean = mean;
+    stats->ac_power = (uint32_t)(spread / ((uint64_t)count * count));
+    stats->ac_rms = fx_isqrt(stats->ac_power);
+    stats->peak = (max - mean > mean - min) ? max - mean : mean - min;
+}
+
+#undef MIC_STATS_ACCUMULATE
+
+// Estatísticas do último bloco lido por mic_sample()
+const MicBlockStats *mic_get_stats() {
+    return &adc_stats;
 }
 
-// Converte a leitura RMS em tensão
+// Bloco lido pelo último mic_sample()
+const uint16_t *mic_get_buffer() {
+    return adc_buffer;
+}
+
+// Calcula a potência média (RMS) das amostras, incluindo o nível DC
+float mic_get_rms() {
+    float dc = adc_stats.dc_mean;
+    return sqrtf(dc * dc + (float)adc_stats.ac_power);
+}
+
+// Converte o RMS da componente AC em tensão
 float mic_get_voltage() {
-    float rms = mic_get_rms();
-    return fabs(rms * 3.3f / (1 << 12u) - 1.65f);
-}
\ No newline at end of file
+    return sqrtf((float)adc_stats.ac_power) * 3.3f / (1 << 12u);
+}
+
@@ -2,17 +2,57 @@
 #define MIC_H
 
 #include <stdint.h>
+#include <stdbool.h>
 
 // Configurações padrão do ADC
 #define MIC_CHANNEL 2
 #define MIC_PIN (26 + MIC_CHANNEL)
-#define ADC_CLOCK_DIV 96.f
+#define ADC_CLOCK_DIV 999.f // 48 kHz: faixa de áudio completa e folga de ciclos para a FFT
 #define SAMPLES 200
 
+// Faixa do ADC de 12 bits e margem usada para contar amostras saturadas
+#define MIC_ADC_MAX 4095
+#define MIC_SATURATION_MARGIN 8
+
+// Referência dos cruzamentos antes do primeiro bloco: o meio da escala
+#define MIC_ZC_REFERENCE_DEFAULT ((MIC_ADC_MAX + 1) / 2)
+
+// Taxa de amostragem do ADC em modo contínuo: 48 MHz / (1 + ADC_CLOCK_DIV)
+#define MIC_SAMPLE_RATE_HZ (48000000.f / (1.f + ADC_CLOCK_DIV))
+
+// Callback chamado a cada bloco de SAMPLES amostras capturado pelo DMA.
+// Executa em contexto de interrupção: o bloco só é válido até o próximo
+// bloco ficar pronto, então o tratamento deve ser curto.
+typedef void (*mic_block_callback_t)(const uint16_t *block, uint32_t count);
+
+// Estatísticas de um bloco, calculadas em uma única passada (valores em códigos do ADC)
+typedef struct {
+    uint16_t dc_mean;        // Média do bloco (nível DC)
+    uint16_t ac_rms;         // RMS da componente AC (DC removido antes de elevar ao quadrado)
+    uint32_t ac_power;       // Potência média da componente AC (códigos^2)
+    uint16_t min;            // Menor amostra
+    uint16_t max;            // Maior amostra
+    uint16_t peak;           // Maior desvio absoluto em relação ao DC
+    uint16_t saturated;      // Amostras a até MIC_SATURATION_MARGIN dos limites do ADC
+    uint16_t zero_crossings; // Cruzamentos do nível de referência (o DC do bloco anterior em mic_sample)
+    uint16_t count;          // Número de amostras do bloco
+} MicBlockStats;
+
 // Funções públicas da biblioteca
 void mic_init();
 void mic_sample();
 float mic_get_rms();
 float mic_get_voltage();
+// Função pura: o resultado depende só do bloco e da referência dos cruzamentos
+void mic_block_stats(const uint16_t *block, uint32_t count, uint16_t reference, MicBlockStats *stats);
+const MicBlockStats *mic_get_stats();
+const uint16_t *mic_get_buffer();
+
+// Captura contínua (ADC FIFO -> DMA em buffer duplo ping-pong)
+void mic_start_capture(mic_block_callback_t callback);
+void mic_stop_capture();
+bool mic_is_capturing();
+uint32_t mic_get_block_count();
+uint32_t mic_get_dropped_blocks();
 
-#endif // MIC_H
\ No newline at end of file
+#endif // MIC_H
@@ -0,0 +1,378 @@
+#include "inc/audio_analyzer.h"
+#include "inc/audio_history.h"
+#include "inc/display_manager.h"
+#include "inc/dsp_pipeline.h"
+#include "inc/tone_detector.h"
+#include "inc/probe.h"
+#include "drivers/display-lcd/ssd1306.h"
+#include "drivers/mic/mic.h"
+#include "pico/stdlib.h"
+#include "pico_mock.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @file mic_monitor_host.c
+ * @brief Executa a análise e o desenho do firmware no host
+ *
+ * O processamento de cada bloco é o mesmo do núcleo 1 (dsp_pipeline.c);
+ * o resultado de cada período vai para o histórico e para a tela, como
+ * nas tarefas do núcleo 0, em um laço só, sobre o SDK simulado em
+ * host/pico_mock: o
+ * ADC lê um WAV ou um gerador e o display é reconstruído a partir do
+ * que o driver envia pelo I2C.
+ */
+
+typedef struct
+{
+    const char *wav;
+    bool loop;
+    float tone_hz;
+    float amplitude;
+    float noise;
+    float seconds;
+    DisplayMode screen;
+    const char *pbm;
+    bool check_not_low;
+    uint32_t step_ms;
+    float step_amplitude;
+    float step_noise;
+    uint32_t check_floor_ms;
+} HostOptions;
+
+// Diferença relativa aceita entre o ruído de fundo e o nível de um sinal estável
+#define FLOOR_TOLERANCE 0.25f
+
+static const char *screen_names[DISPLAY_MODE_COUNT] = {
+    [DISPLAY_MODE_GRAPH] = "grafico",
+    [DISPLAY_MODE_MONITOR] = "monitor",
+    [DISPLAY_MODE_SPECTRUM] = "espectro",
+    [DISPLAY_MODE_BANDS] = "bandas",
+};
+
+static void usage(const char *program)
+{
+    fprintf(stderr,
+            "uso: %s [opções]\n"
+            "  --wav ARQUIVO        lê o ADC de um WAV PCM de 16 bits\n"
+            "  --loop               repete o WAV\n"
+            "  --tone HZ            gerador: frequência do seno (padrão 1000)\n"
+            "  --amplitude CODIGOS  gerador: amplitude de pico do seno (padrão 60)\n"
+            "  --noise CODIGOS      gerador: amplitude de pico do ruído (padrão 8)\n"
+            "  --seconds S          duração simulada (padrão 5; fim do WAV encerra antes)\n"
+            "  --screen TELA        grafico, monitor, espectro ou bandas (padrão grafico)\n"
+            "  --pbm ARQUIVO        grava o último quadro do display em PBM\n"
+            "  --check-not-low      falha se algum período for marcado como volume baixo\n"
+            "  --step-ms MS         gerador: troca a amplitude e o ruído neste instante\n"
+            "  --step-amplitude C   gerador: amplitude do seno depois da troca (padrão: a mesma)\n"
+            "  --step-noise C       gerador: amplitude do ruído depois da troca (padrão: a mesma)\n"
+            "  --check-floor-ms MS  falha se, MS depois da troca, o ruído de fundo não seguir o nível\n",
+            program);
+}
+
+static bool parse_screen(const char *name, DisplayMode *screen)
+{
+    for (int s = 0; s < DISPLAY_MODE_COUNT; s++)
+    {
+        if (strcmp(name, screen_names[s]) == 0)
+        {
+            *screen = (DisplayMode)s;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool parse_options(int argc, char **argv, HostOptions *options)
+{
+    *options = (HostOptions){
+        .tone_hz = 1000.0f,
+        .amplitude = 60.0f,
+        .noise = 8.0f,
+        .seconds = 5.0f,
+        .screen = DISPLAY_MODE_GRAPH,
+        .step_amplitude = -1.0f,
+        .step_noise = -1.0f,
+    };
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--loop") == 0)
+        {
+            options->loop = true;
+            continue;
+        }
+        if (strcmp(arg, "--check-not-low") == 0)
+        {
+            options->check_not_low = true;
+            continue;
+        }
+        if (!value)
+        {
+            return false;
+        }
+        i++;
+
+        if (strcmp(arg, "--wav") == 0)
+        {
+            options->wav = value;
+        }
+        else if (strcmp(arg, "--tone") == 0)
+        {
+            options->tone_hz = strtof(value, NULL);
+        }
+        else if (strcmp(arg, "--amplitude") == 0)
+        {
+            options->amplitude = strtof(value, NULL);
+        }
+        else if (strcmp(arg, "--noise") == 0)
+        {
+            options->noise = strtof(value, NULL);
+        }
+        else if (strcmp(arg, "--seconds") == 0)
+        {
+            options->seconds = strtof(value, NULL);
+        }
+        else if (strcmp(arg, "--screen") == 0)
+        {
+            if (!parse_screen(value, &options->screen))
+            {
+                return false;
+            }
+        }
+        else if (strcmp(arg, "--pbm") == 0)
+        {
+            options->pbm = value;
+        }
+        else if (strcmp(arg, "--step-ms") == 0)
+        {
+            options->step_ms = strtoul(value, NULL, 10);
+        }
+        else if (strcmp(arg, "--step-amplitude") == 0)
+        {
+            options->step_amplitude = strtof(value, NULL);
+        }
+        else if (strcmp(arg, "--step-noise") == 0)
+        {
+            options->step_noise = strtof(value, NULL);
+        }
+        else if (strcmp(arg, "--check-floor-ms") == 0)
+        {
+            options->check_floor_ms = strtoul(value, NULL, 10);
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    // O que a troca não mudar continua igual
+    if (options->step_amplitude < 0.0f)
+    {
+        options->step_amplitude = options->amplitude;
+    }
+    if (options->step_noise < 0.0f)
+    {
+        options->step_noise = options->noise;
+    }
+    return true;
+}
+
+// Resultado do último período, entregue por dsp_pipeline_process_block()
+static AudioAnalysisFx period_result;
+static bool period_ready = false;
+
+static void on_result(const AudioAnalysisFx *analysis)
+{
+    period_result = *analysis;
+    period_ready = true;
+}
+
+/**
+ * Imprime os tons detectados e mostra no monitor o tom em andamento,
+ * como report_tones() em mic-monitor.c
+ */
+static void report_tones(void)
+{
+    static uint32_t shown_hz = 0;
+    ToneEvent e;
+    while (tone_detector_pop_event(&e))
+    {
+        const ToneDetectorConfig *config = tone_detector_config(e.detector);
+        printf("tom %s (%lu Hz) %s: %lu ms, %lu%% da potencia\n",
+               config->name, (unsigned long)config->frequency_hz, e.active ? "inicio" : "fim",
+               (unsigned long)e.duration_ms, (unsigned long)((e.share * 100) >> 16));
+        if (e.active || config->frequency_hz == shown_hz)
+        {
+            shown_hz = e.active ? config->frequency_hz : 0;
+            display_set_tone(shown_hz);
+        }
+    }
+}
+
+/**
+ * Desenha a tela escolhida, como render_display() em mic-monitor.c
+ */
+static void render(DisplayMode screen, const AudioAnalysisFx *analysis)
+{
+    switch (screen)
+    {
+    case DISPLAY_MODE_GRAPH:
+        display_volume_graph();
+        break;
+    case DISPLAY_MODE_SPECTRUM:
+        display_spectrum();
+        break;
+    case DISPLAY_MODE_BANDS:
+        display_bands(&analysis->bands);
+        break;
+    default:
+        display_audio_monitor(audio_analysis_to_float(analysis));
+        break;
+    }
+    display_flush();
+}
+
+/**
+ * Um sinal estável não tem nada acima do ruído: o ruído de fundo
+ * convergido é o próprio nível, dentro de FLOOR_TOLERANCE
+ */
+static bool floor_follows_level(const AudioAnalysisFx *analysis)
+{
+    float level = FX_TO_FLOAT(analysis->voltage);
+    float floor = FX_TO_FLOAT(analysis->noise_floor);
+    return fabsf(floor - level) <= level * FLOOR_TOLERANCE;
+}
+
+static void report(uint32_t ms, const AudioAnalysisFx *analysis)
+{
+    printf("%6lu ms | rms %7.1f | %5.3f V ruido %5.3f V | %5.1f dB | A fast %5.1f slow %5.1f | C fast %5.1f%s%s\n",
+           (unsigned long)ms,
+           FX_TO_FLOAT(analysis->rms_value),
+           FX_TO_FLOAT(analysis->voltage),
+           FX_TO_FLOAT(analysis->noise_floor),
+           FX_TO_FLOAT(analysis->estimated_db),
+           FX_TO_FLOAT(analysis->levels.db[SOUND_WEIGHTING_A][SOUND_TIME_FAST]),
+           FX_TO_FLOAT(analysis->levels.db[SOUND_WEIGHTING_A][SOUND_TIME_SLOW]),
+           FX_TO_FLOAT(analysis->levels.db[SOUND_WEIGHTING_C][SOUND_TIME_FAST]),
+           analysis->is_clipping ? " | clipping" : "",
+           analysis->is_low_volume ? " | baixo" : "");
+}
+
+int main(int argc, char **argv)
+{
+    HostOptions options;
+    if (!parse_options(argc, argv, &options))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (options.wav)
+    {
+        if (!pico_mock_adc_open_wav(options.wav, options.loop))
+        {
+            fprintf(stderr, "não foi possível ler %s\n", options.wav);
+            return 1;
+        }
+    }
+    else
+    {
+        pico_mock_adc_set_generator(options.tone_hz, options.amplitude, options.noise);
+    }
+
+    stdio_init_all();
+    ssd1306_Init();
+    dsp_pipeline_init();
+
+    const uint32_t duration_ms = (uint32_t)(options.seconds * 1000.0f);
+    uint32_t start_ms = to_ms_since_boot(get_absolute_time());
+    uint32_t next_report_ms = 1000;
+    uint32_t frames = 0;
+    uint32_t low_periods = 0;
+    bool stepped = false;
+    uint32_t floor_periods = 0;
+    uint32_t floor_misses = 0;
+
+    while (1)
+    {
+        // Mesma passada do núcleo 1; mic_sample() dorme até o próximo bloco do DMA
+        dsp_pipeline_process_block(on_result);
+        if (!period_ready)
+        {
+            continue;
+        }
+        period_ready = false;
+
+        // Parte do núcleo 0: histórico, tons e tela
+        audio_history_push(&period_result);
+        report_tones();
+        render(options.screen, &period_result);
+        frames++;
+        if (period_result.is_low_volume)
+        {
+            low_periods++;
+        }
+
+        uint32_t elapsed_ms = to_ms_since_boot(get_absolute_time()) - start_ms;
+        if (options.check_floor_ms && elapsed_ms >= options.step_ms + options.check_floor_ms)
+        {
+            floor_periods++;
+            if (!floor_follows_level(&period_result))
+            {
+                floor_misses++;
+            }
+        }
+        if (options.step_ms && !stepped && elapsed_ms >= options.step_ms && !options.wav)
+        {
+            pico_mock_adc_set_generator(options.tone_hz, options.step_amplitude, options.step_noise);
+            stepped = true;
+        }
+        if (elapsed_ms >= next_report_ms)
+        {
+            report(elapsed_ms, &period_result);
+            next_report_ms += 1000;
+        }
+        if (elapsed_ms >= duration_ms || pico_mock_adc_finished())
+        {
+            break;
+        }
+    }
+
+    // Espera o último quadro chegar ao display antes de capturar
+    ssd1306_WaitForFlush();
+    mic_stop_capture();
+
+    printf("%lu blocos (%lu perdidos), %lu quadros, %lu bytes no I2C, ADC a %.0f Hz\n",
+           (unsigned long)mic_get_block_count(), (unsigned long)mic_get_dropped_blocks(),
+           (unsigned long)frames, (unsigned long)pico_mock_ssd1306_bytes(), pico_mock_adc_rate_hz());
+    probe_dump();
+
+    if (options.pbm)
+    {
+        if (!pico_mock_ssd1306_write_pbm(options.pbm))
+        {
+            fprintf(stderr, "não foi possível gravar %s\n", options.pbm);
+            return 1;
+        }
+        printf("tela %s gravada em %s\n", screen_names[options.screen], options.pbm);
+    }
+    if (options.check_not_low && low_periods)
+    {
+        fprintf(stderr, "%lu de %lu períodos marcados como volume baixo\n",
+                (unsigned long)low_periods, (unsigned long)frames);
+        return 1;
+    }
+    if (options.check_floor_ms && (floor_periods == 0 || floor_misses))
+    {
+        fprintf(stderr, "%lu de %lu períodos com o ruído de fundo longe do nível\n",
+                (unsigned long)floor_misses, (unsigned long)floor_periods);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,14 @@
+#ifndef PICO_MOCK_ANSI_H
+#define PICO_MOCK_ANSI_H
+
+// Cabeçalho da newlib incluído por ssd1306.h; só as macros de ligação C
+
+#ifdef __cplusplus
+#define _BEGIN_STD_C extern "C" {
+#define _END_STD_C }
+#else
+#define _BEGIN_STD_C
+#define _END_STD_C
+#endif
+
+#endif // PICO_MOCK_ANSI_H
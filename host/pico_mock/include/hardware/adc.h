@@ -0,0 +1,34 @@
+#ifndef PICO_MOCK_ADC_H
+#define PICO_MOCK_ADC_H
+#include "pico/types.h"
+
+typedef struct
+{
+    volatile uint32_t cs;
+    volatile uint32_t result;
+    volatile uint32_t fcs;
+    volatile uint32_t fifo;
+    volatile uint32_t div;
+    volatile uint32_t intr;
+    volatile uint32_t inte;
+    volatile uint32_t intf;
+    volatile uint32_t ints;
+} adc_hw_t;
+
+/**
+ * @brief Registradores do ADC
+ * O DMA simulado reconhece &adc_hw->fifo como origem e puxa as amostras
+ * da fonte escolhida em pico_mock.h, no ritmo do divisor de clock
+ */
+extern adc_hw_t *adc_hw;
+
+void adc_init(void);
+void adc_gpio_init(uint gpio);
+void adc_select_input(uint input);
+void adc_set_clkdiv(float clkdiv);
+void adc_run(bool run);
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift);
+void adc_fifo_drain(void);
+uint16_t adc_read(void);
+
+#endif // PICO_MOCK_ADC_H
@@ -0,0 +1,20 @@
+#ifndef PICO_MOCK_CLOCKS_H
+#define PICO_MOCK_CLOCKS_H
+#include "pico/types.h"
+
+enum clock_index
+{
+    clk_ref = 4,
+    clk_sys = 5,
+    clk_adc = 7,
+};
+
+/**
+ * @brief Frequência de um clock
+ *
+ * clk_sys vale 1 GHz no host: o SysTick simulado conta nanossegundos
+ * do relógio do host, então ciclos / clock_get_hz(clk_sys) dá o tempo real.
+ */
+uint32_t clock_get_hz(enum clock_index clock);
+
+#endif // PICO_MOCK_CLOCKS_H
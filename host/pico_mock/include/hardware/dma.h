@@ -0,0 +1,70 @@
+#ifndef PICO_MOCK_DMA_H
+#define PICO_MOCK_DMA_H
+#include "pico/types.h"
+
+#define NUM_DMA_CHANNELS 12
+
+#define DREQ_I2C0_TX 32
+#define DREQ_I2C1_TX 34
+#define DREQ_ADC 36
+#define DREQ_FORCE 0x3f
+
+enum dma_channel_transfer_size
+{
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2,
+};
+
+/**
+ * @brief Configuração de um canal (campos explícitos no lugar do registrador CTRL)
+ */
+typedef struct
+{
+    uint8_t size;         ///< enum dma_channel_transfer_size
+    bool read_increment;  ///< Avança o endereço de leitura
+    bool write_increment; ///< Avança o endereço de escrita
+    uint8_t dreq;         ///< DREQ que dita o ritmo (DREQ_FORCE = sem ritmo)
+    uint8_t chain_to;     ///< Canal disparado no fim (o próprio canal = sem chain)
+    bool irq_quiet;       ///< Fim sem interrupção
+} dma_channel_config;
+
+typedef struct
+{
+    volatile uint32_t ints0;
+    volatile uint32_t ints1;
+    volatile uint32_t abort; ///< Bits escritos são tratados na próxima espera
+} dma_hw_t;
+
+extern dma_hw_t *dma_hw;
+
+int dma_claim_unused_channel(bool required);
+void dma_channel_unclaim(uint channel);
+dma_channel_config dma_channel_get_default_config(uint channel);
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size);
+void channel_config_set_read_increment(dma_channel_config *c, bool incr);
+void channel_config_set_write_increment(dma_channel_config *c, bool incr);
+void channel_config_set_dreq(dma_channel_config *c, uint dreq);
+void channel_config_set_chain_to(dma_channel_config *c, uint chain_to);
+void channel_config_set_irq_quiet(dma_channel_config *c, bool irq_quiet);
+void channel_config_set_high_priority(dma_channel_config *c, bool high_priority);
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger);
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger);
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger);
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger);
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count);
+void dma_channel_start(uint channel);
+void dma_channel_abort(uint channel);
+bool dma_channel_is_busy(uint channel);
+void dma_channel_wait_for_finish_blocking(uint channel);
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled);
+void dma_channel_set_irq1_enabled(uint channel, bool enabled);
+bool dma_channel_get_irq0_status(uint channel);
+bool dma_channel_get_irq1_status(uint channel);
+void dma_channel_acknowledge_irq0(uint channel);
+void dma_channel_acknowledge_irq1(uint channel);
+
+#endif // PICO_MOCK_DMA_H
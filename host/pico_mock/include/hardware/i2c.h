@@ -0,0 +1,60 @@
+#ifndef PICO_MOCK_I2C_H
+#define PICO_MOCK_I2C_H
+#include "pico/types.h"
+
+/**
+ * @brief Registradores do I2C usados pelo firmware
+ * Palavras escritas em data_cmd (pelo DMA) vão para o dispositivo em tar;
+ * o bit STOP fecha a transação
+ */
+typedef struct
+{
+    volatile uint32_t tar;
+    volatile uint32_t data_cmd;
+    volatile uint32_t enable;
+    volatile uint32_t status;
+    volatile uint32_t txflr;
+    volatile uint32_t raw_intr_stat;
+    volatile uint32_t clr_tx_abrt;
+    volatile uint32_t clr_stop_det;
+    volatile uint32_t tx_abrt_source;
+} i2c_hw_t;
+
+typedef struct i2c_inst
+{
+    i2c_hw_t *hw;
+    bool restart_on_next;
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst;
+extern i2c_inst_t i2c1_inst;
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+#define I2C_IC_DATA_CMD_STOP_BITS 0x00000200u
+#define I2C_IC_DATA_CMD_RESTART_BITS 0x00000400u
+#define I2C_IC_STATUS_ACTIVITY_BITS 0x00000001u
+#define I2C_IC_STATUS_TFE_BITS 0x00000004u
+#define I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS 0x00000040u
+#define I2C_IC_RAW_INTR_STAT_STOP_DET_BITS 0x00000200u
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+uint i2c_hw_index(i2c_inst_t *i2c);
+
+static inline i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c)
+{
+    return i2c->hw;
+}
+
+static inline uint i2c_get_dreq(i2c_inst_t *i2c, bool is_tx)
+{
+    return 32u + 2u * i2c_hw_index(i2c) + (is_tx ? 0u : 1u);
+}
+
+static inline size_t i2c_get_write_available(i2c_inst_t *i2c)
+{
+    return 16u - i2c->hw->txflr;
+}
+
+#endif // PICO_MOCK_I2C_H
@@ -0,0 +1,18 @@
+#ifndef PICO_MOCK_IRQ_H
+#define PICO_MOCK_IRQ_H
+#include "pico/types.h"
+
+typedef void (*irq_handler_t)(void);
+
+#define DMA_IRQ_0 11
+#define DMA_IRQ_1 12
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+
+// As interrupções são chamadas pelo modelo do hardware, dentro de __wfe() e das esperas
+void irq_set_exclusive_handler(uint num, irq_handler_t handler);
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority);
+void irq_remove_handler(uint num, irq_handler_t handler);
+void irq_set_enabled(uint num, bool enabled);
+void irq_set_priority(uint num, uint8_t priority);
+
+#endif // PICO_MOCK_IRQ_H
@@ -0,0 +1,25 @@
+#ifndef PICO_MOCK_SYSTICK_H
+#define PICO_MOCK_SYSTICK_H
+#include "pico/types.h"
+
+typedef struct
+{
+    volatile uint32_t csr;
+    volatile uint32_t rvr;
+    volatile uint32_t cvr;
+    volatile uint32_t calib;
+} systick_hw_t;
+
+#define M0PLUS_SYST_CSR_ENABLE_BITS 0x00000001u
+#define M0PLUS_SYST_CSR_CLKSOURCE_BITS 0x00000004u
+
+/**
+ * @brief Registradores do SysTick com cvr atualizado a cada acesso
+ *
+ * O contador desce um por nanossegundo do relógio monotônico do host.
+ */
+systick_hw_t *pico_mock_systick(void);
+
+#define systick_hw (pico_mock_systick())
+
+#endif // PICO_MOCK_SYSTICK_H
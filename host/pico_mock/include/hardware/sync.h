@@ -0,0 +1,22 @@
+#ifndef PICO_MOCK_SYNC_H
+#define PICO_MOCK_SYNC_H
+#include "pico/types.h"
+
+/**
+ * @brief Dorme até o próximo evento do hardware simulado
+ *
+ * No host, avança o tempo virtual até o fim do próximo bloco do DMA
+ * (ou 1 ms, se nada está em andamento) e executa as interrupções.
+ */
+void __wfe(void);
+void __wfi(void);
+
+// Um núcleo só no host: as barreiras e o aviso entre núcleos não fazem nada
+static inline void __sev(void) {}
+static inline void __dmb(void) {}
+static inline void __compiler_memory_barrier(void) {}
+
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+
+#endif // PICO_MOCK_SYNC_H
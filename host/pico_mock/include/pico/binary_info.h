@@ -0,0 +1,7 @@
+#ifndef PICO_MOCK_BINARY_INFO_H
+#define PICO_MOCK_BINARY_INFO_H
+
+// Metadados do binário não existem no host
+#define bi_decl(...)
+
+#endif // PICO_MOCK_BINARY_INFO_H
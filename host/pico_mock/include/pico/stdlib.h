@@ -0,0 +1,23 @@
+#ifndef PICO_MOCK_STDLIB_H
+#define PICO_MOCK_STDLIB_H
+#include <stdio.h>
+#include "pico/types.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+bool stdio_init_all(void);
+
+/**
+ * @brief Sem entrada no host: sempre PICO_ERROR_TIMEOUT
+ */
+int getchar_timeout_us(uint32_t timeout_us);
+
+/**
+ * @brief Espera ativa: no host, avança o tempo virtual em 1 us
+ *
+ * Os laços que esperam o hardware (DMA abortado, fila do I2C) saem
+ * porque o modelo do hardware anda a cada chamada.
+ */
+void tight_loop_contents(void);
+
+#endif // PICO_MOCK_STDLIB_H
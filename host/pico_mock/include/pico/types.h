@@ -0,0 +1,22 @@
+#ifndef PICO_MOCK_TYPES_H
+#define PICO_MOCK_TYPES_H
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Tipos e atributos do SDK que o código do firmware usa no host
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+#define __not_in_flash_func(func) func
+#define __time_critical_func(func) func
+#define __aligned(n) __attribute__((aligned(n)))
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#define hard_assert(x) ((void)0)
+
+#define PICO_OK 0
+#define PICO_ERROR_GENERIC -1
+#define PICO_ERROR_TIMEOUT -1
+
+#endif // PICO_MOCK_TYPES_H
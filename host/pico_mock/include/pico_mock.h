@@ -0,0 +1,97 @@
+#ifndef PICO_MOCK_H
+#define PICO_MOCK_H
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @file pico_mock.h
+ * @brief Controle do SDK simulado pelo programa do host
+ *
+ * O tempo é virtual: só anda quando o firmware espera (__wfe, sleep_ms,
+ * tight_loop_contents) ou quando pico_mock_advance_us() é chamada. Nessas
+ * esperas o modelo do hardware completa os blocos do DMA do ADC e executa
+ * as interrupções, na ordem e nos instantes em que ocorreriam na placa.
+ */
+
+/**
+ * @brief Avança o tempo virtual, executando o hardware até lá
+ *
+ * @param us Microssegundos
+ */
+void pico_mock_advance_us(uint64_t us);
+
+// ==================== Fonte do ADC ====================
+
+/**
+ * @brief Alimenta o ADC com um gerador sintético
+ *
+ * A amostra é o meio da escala (2048) mais um seno e ruído branco
+ * uniforme, em códigos do ADC de 12 bits, limitada a 0..4095.
+ *
+ * @param tone_hz Frequência do seno (0 = sem seno)
+ * @param tone_amplitude Amplitude de pico do seno, em códigos
+ * @param noise_amplitude Amplitude de pico do ruído, em códigos
+ */
+void pico_mock_adc_set_generator(float tone_hz, float tone_amplitude, float noise_amplitude);
+
+/**
+ * @brief Alimenta o ADC com um arquivo WAV
+ *
+ * Aceita PCM de 16 bits, com qualquer taxa e número de canais (usa o
+ * primeiro). A taxa é convertida para a do ADC pela amostra mais
+ * próxima, e o fundo de escala do arquivo vira a faixa inteira do ADC.
+ *
+ * @param path Caminho do arquivo
+ * @param loop Recomeça do início no fim do arquivo
+ * @return bool Falso se o arquivo não pôde ser lido
+ */
+bool pico_mock_adc_open_wav(const char *path, bool loop);
+
+/**
+ * @brief Indica que o WAV (sem repetição) chegou ao fim
+ *
+ * Depois do fim o ADC lê o meio da escala.
+ *
+ * @return bool Verdadeiro depois da última amostra do arquivo
+ */
+bool pico_mock_adc_finished(void);
+
+/**
+ * @brief Taxa de amostragem atual do ADC
+ *
+ * @return float Amostras por segundo (48 MHz / (1 + divisor))
+ */
+float pico_mock_adc_rate_hz(void);
+
+// ==================== Display SSD1306 ====================
+
+/**
+ * @brief Pixel da memória do display
+ *
+ * A memória é montada a partir dos comandos e dados recebidos pelo I2C
+ * (com e sem DMA), no modo de endereçamento que o driver configurou.
+ *
+ * @param x Coluna (0..127)
+ * @param y Linha (0..63)
+ * @return bool Pixel aceso
+ */
+bool pico_mock_ssd1306_pixel(uint8_t x, uint8_t y);
+
+/**
+ * @brief Bytes recebidos pelo display desde o início
+ *
+ * @return uint32_t Bytes de comando e de dados
+ */
+uint32_t pico_mock_ssd1306_bytes(void);
+
+/**
+ * @brief Grava a memória do display em PBM de texto (P1)
+ *
+ * O formato de texto deixa os quadros comparáveis com diff.
+ *
+ * @param path Caminho do arquivo
+ * @return bool Falso se o arquivo não pôde ser gravado
+ */
+bool pico_mock_ssd1306_write_pbm(const char *path);
+
+#endif // PICO_MOCK_H
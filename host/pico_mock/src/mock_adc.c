@@ -0,0 +1,270 @@
+#include "pico_mock.h"
+#include "pico_mock_internal.h"
+#include "hardware/adc.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ADC_CLOCK_HZ 48000000.0
+#define ADC_MID_SCALE 2048
+#define ADC_MAX_CODE 4095
+#define MOCK_PI 3.14159265358979323846
+
+static adc_hw_t adc_regs;
+adc_hw_t *adc_hw = &adc_regs;
+
+// Ritmo do modo contínuo: uma conversão a cada (1 + div) ciclos de 48 MHz
+static double adc_rate = ADC_CLOCK_HZ / 96.0; // 96 ciclos por conversão sem divisor
+static bool adc_running = false;
+static uint64_t run_start_us = 0;     // Início do modo contínuo atual
+static uint64_t run_start_sample = 0; // Amostras convertidas antes dele
+
+// Gerador sintético
+static double tone_hz = 0.0;
+static double tone_amplitude = 0.0;
+static double noise_amplitude = 0.0;
+static uint32_t noise_state = 0x12345678u;
+
+// WAV: primeiro canal em memória
+static int16_t *wav_samples = NULL;
+static uint64_t wav_count = 0;
+static uint32_t wav_rate = 0;
+static bool wav_loop = false;
+static bool wav_finished = false;
+
+// ==================== API do SDK ====================
+
+void adc_init(void)
+{
+    memset(&adc_regs, 0, sizeof(adc_regs));
+    adc_running = false;
+}
+
+void adc_gpio_init(uint gpio)
+{
+    (void)gpio;
+}
+
+void adc_select_input(uint input)
+{
+    adc_regs.cs = (adc_regs.cs & ~(7u << 12)) | ((input & 7u) << 12);
+}
+
+void adc_set_clkdiv(float clkdiv)
+{
+    // Abaixo de 96 ciclos o ADC não acompanha; a placa fica no limite de 500 kS/s
+    double cycles = clkdiv < 95.0f ? 96.0 : 1.0 + clkdiv;
+    uint64_t samples = mock_adc_samples_at(mock_now_us());
+    adc_rate = ADC_CLOCK_HZ / cycles;
+    run_start_sample = samples;
+    run_start_us = mock_now_us();
+}
+
+void adc_run(bool run)
+{
+    if (run == adc_running)
+    {
+        return;
+    }
+    run_start_sample = mock_adc_samples_at(mock_now_us());
+    run_start_us = mock_now_us();
+    adc_running = run;
+}
+
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift)
+{
+    (void)en;
+    (void)dreq_en;
+    (void)dreq_thresh;
+    (void)err_in_fifo;
+    (void)byte_shift;
+}
+
+void adc_fifo_drain(void)
+{
+}
+
+uint16_t adc_read(void)
+{
+    // Conversão avulsa: 96 ciclos de 48 MHz (2 us)
+    uint16_t code = mock_adc_code(mock_adc_samples_at(mock_now_us()));
+    pico_mock_advance_us(2);
+    return code;
+}
+
+// ==================== Modelo ====================
+
+bool mock_adc_running(void)
+{
+    return adc_running;
+}
+
+uint64_t mock_adc_samples_at(uint64_t us)
+{
+    if (!adc_running || us <= run_start_us)
+    {
+        return run_start_sample;
+    }
+    return run_start_sample + (uint64_t)((double)(us - run_start_us) * adc_rate / 1e6);
+}
+
+uint64_t mock_adc_sample_time_us(uint64_t sample)
+{
+    if (sample <= run_start_sample)
+    {
+        return run_start_us;
+    }
+    return run_start_us + (uint64_t)ceil((double)(sample - run_start_sample) * 1e6 / adc_rate);
+}
+
+static double next_noise(void)
+{
+    // LCG determinístico: a mesma execução gera os mesmos quadros
+    noise_state = noise_state * 1664525u + 1013904223u;
+    return (double)(noise_state >> 8) / (double)(1u << 23) - 1.0;
+}
+
+uint16_t mock_adc_code(uint64_t sample)
+{
+    double value = ADC_MID_SCALE;
+
+    if (wav_samples)
+    {
+        uint64_t index = (uint64_t)((double)sample * wav_rate / adc_rate);
+        if (index >= wav_count)
+        {
+            if (wav_loop)
+            {
+                index %= wav_count;
+            }
+            else
+            {
+                wav_finished = true;
+                return ADC_MID_SCALE;
+            }
+        }
+        value += wav_samples[index] / 16.0;
+    }
+    else
+    {
+        if (tone_hz > 0.0)
+        {
+            value += tone_amplitude * sin(2.0 * MOCK_PI * tone_hz * (double)sample / adc_rate);
+        }
+        if (noise_amplitude > 0.0)
+        {
+            value += noise_amplitude * next_noise();
+        }
+    }
+
+    long code = lround(value);
+    return (uint16_t)(code < 0 ? 0 : code > ADC_MAX_CODE ? ADC_MAX_CODE : code);
+}
+
+// ==================== Fontes ====================
+
+void pico_mock_adc_set_generator(float frequency_hz, float amplitude, float noise)
+{
+    free(wav_samples);
+    wav_samples = NULL;
+    wav_count = 0;
+    tone_hz = frequency_hz;
+    tone_amplitude = amplitude;
+    noise_amplitude = noise;
+}
+
+static uint32_t read_le(const uint8_t *p, int bytes)
+{
+    uint32_t value = 0;
+    for (int i = bytes - 1; i >= 0; i--)
+    {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+bool pico_mock_adc_open_wav(const char *path, bool loop)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        return false;
+    }
+
+    uint8_t header[12];
+    bool ok = fread(header, 1, sizeof(header), file) == sizeof(header) &&
+              !memcmp(header, "RIFF", 4) && !memcmp(header + 8, "WAVE", 4);
+
+    uint16_t channels = 0;
+    uint16_t bits = 0;
+    uint32_t rate = 0;
+    int16_t *samples = NULL;
+    uint64_t count = 0;
+
+    // Percorre os chunks até achar fmt e data
+    while (ok && !samples)
+    {
+        uint8_t chunk[8];
+        if (fread(chunk, 1, sizeof(chunk), file) != sizeof(chunk))
+        {
+            ok = false;
+            break;
+        }
+        uint32_t size = read_le(chunk + 4, 4);
+
+        if (!memcmp(chunk, "fmt ", 4) && size >= 16)
+        {
+            uint8_t fmt[16];
+            ok = fread(fmt, 1, sizeof(fmt), file) == sizeof(fmt);
+            uint16_t format = (uint16_t)read_le(fmt, 2);
+            channels = (uint16_t)read_le(fmt + 2, 2);
+            rate = read_le(fmt + 4, 4);
+            bits = (uint16_t)read_le(fmt + 14, 2);
+            ok = ok && (format == 1 || format == 0xFFFE) && bits == 16 && channels > 0 && rate > 0;
+            fseek(file, (long)(size - sizeof(fmt) + (size & 1)), SEEK_CUR);
+        }
+        else if (!memcmp(chunk, "data", 4) && channels)
+        {
+            uint32_t frame = 2u * channels;
+            count = size / frame;
+            samples = malloc(count ? count * sizeof(int16_t) : 1);
+            uint8_t buffer[16];
+            for (uint64_t i = 0; ok && i < count; i++)
+            {
+                ok = frame <= sizeof(buffer) ? fread(buffer, 1, frame, file) == frame
+                                             : fread(buffer, 1, 2, file) == 2 && !fseek(file, frame - 2, SEEK_CUR);
+                samples[i] = (int16_t)read_le(buffer, 2);
+            }
+        }
+        else
+        {
+            fseek(file, (long)(size + (size & 1)), SEEK_CUR);
+        }
+    }
+    fclose(file);
+
+    if (!ok || !samples || count == 0)
+    {
+        free(samples);
+        return false;
+    }
+
+    pico_mock_adc_set_generator(0.0f, 0.0f, 0.0f);
+    wav_samples = samples;
+    wav_count = count;
+    wav_rate = rate;
+    wav_loop = loop;
+    wav_finished = false;
+    return true;
+}
+
+bool pico_mock_adc_finished(void)
+{
+    return wav_finished;
+}
+
+float pico_mock_adc_rate_hz(void)
+{
+    return (float)adc_rate;
+}
@@ -0,0 +1,363 @@
+#include "pico_mock_internal.h"
+#include "hardware/dma.h"
+#include "hardware/adc.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+/**
+ * Estado de um canal simulado
+ *
+ * Canais lendo &adc_hw->fifo andam no ritmo do ADC e terminam em
+ * mock_dma_run_until(); os outros (memória e FIFO do I2C) terminam
+ * no disparo, como se a transferência fosse instantânea.
+ */
+typedef struct
+{
+    bool claimed;
+    bool busy;
+    bool irq0_enabled;
+    bool irq1_enabled;
+    dma_channel_config config;
+    volatile void *write_addr;
+    const volatile void *read_addr;
+    uint32_t count;
+    uint64_t start_sample; ///< Primeira amostra do ADC do bloco em andamento
+} MockDmaChannel;
+
+static MockDmaChannel channels[NUM_DMA_CHANNELS];
+static dma_hw_t dma_regs;
+dma_hw_t *dma_hw = &dma_regs;
+
+static void trigger(uint channel);
+
+static bool paced_by_adc(const MockDmaChannel *c)
+{
+    return c->read_addr == &adc_hw->fifo;
+}
+
+/**
+ * Fim de um canal: dispara o chain e depois levanta a interrupção,
+ * na ordem do hardware
+ */
+static void complete(uint channel)
+{
+    MockDmaChannel *c = &channels[channel];
+    c->busy = false;
+
+    if (c->config.chain_to != channel)
+    {
+        trigger(c->config.chain_to);
+    }
+    if (c->config.irq_quiet)
+    {
+        return;
+    }
+    if (c->irq0_enabled)
+    {
+        dma_regs.ints0 |= 1u << channel;
+        mock_irq_raise(DMA_IRQ_0);
+    }
+    if (c->irq1_enabled)
+    {
+        dma_regs.ints1 |= 1u << channel;
+        mock_irq_raise(DMA_IRQ_1);
+    }
+}
+
+/**
+ * Copia um bloco sem ritmo (memória ou FIFO do I2C)
+ */
+static void transfer_now(uint channel)
+{
+    MockDmaChannel *c = &channels[channel];
+    uint32_t size = 1u << c->config.size;
+    const volatile uint8_t *src = c->read_addr;
+    volatile uint8_t *dst = c->write_addr;
+    i2c_hw_t *i2c = NULL;
+    bool to_i2c = mock_i2c_is_data_cmd(dst, &i2c);
+
+    for (uint32_t i = 0; i < c->count; i++)
+    {
+        uint32_t word = 0;
+        memcpy(&word, (const void *)src, size);
+        if (to_i2c)
+        {
+            mock_i2c_push_word(i2c, word);
+        }
+        else
+        {
+            memcpy((void *)dst, &word, size);
+        }
+        if (c->config.read_increment)
+        {
+            src += size;
+        }
+        if (c->config.write_increment)
+        {
+            dst += size;
+        }
+    }
+    complete(channel);
+}
+
+static void trigger(uint channel)
+{
+    if (channel >= NUM_DMA_CHANNELS)
+    {
+        return;
+    }
+    MockDmaChannel *c = &channels[channel];
+    c->busy = true;
+    if (paced_by_adc(c))
+    {
+        c->start_sample = mock_adc_samples_at(mock_now_us());
+    }
+    else
+    {
+        transfer_now(channel);
+    }
+}
+
+// ==================== Modelo ====================
+
+/**
+ * Canal do ADC em andamento e instante em que ele termina
+ */
+static int adc_channel(uint64_t *end_us)
+{
+    if (!mock_adc_running())
+    {
+        return -1;
+    }
+    for (uint channel = 0; channel < NUM_DMA_CHANNELS; channel++)
+    {
+        const MockDmaChannel *c = &channels[channel];
+        if (c->busy && paced_by_adc(c))
+        {
+            *end_us = mock_adc_sample_time_us(c->start_sample + c->count);
+            return (int)channel;
+        }
+    }
+    return -1;
+}
+
+bool mock_dma_next_event_us(uint64_t *us)
+{
+    return adc_channel(us) >= 0;
+}
+
+void mock_dma_run_until(uint64_t us)
+{
+    uint64_t end_us;
+    int channel;
+    while ((channel = adc_channel(&end_us)) >= 0 && end_us <= us)
+    {
+        MockDmaChannel *c = &channels[channel];
+        mock_set_now_us(end_us);
+
+        // Amostras de 12 bits em meias palavras, como a FIFO entrega com DMA_SIZE_16
+        volatile uint8_t *dst = c->write_addr;
+        uint32_t size = 1u << c->config.size;
+        for (uint32_t i = 0; i < c->count; i++)
+        {
+            uint32_t code = mock_adc_code(c->start_sample + i);
+            memcpy((void *)dst, &code, size);
+            if (c->config.write_increment)
+            {
+                dst += size;
+            }
+        }
+        complete((uint)channel);
+    }
+}
+
+void mock_dma_poll(void)
+{
+    uint32_t abort = dma_regs.abort;
+    if (!abort)
+    {
+        return;
+    }
+    // Abortar não dispara o chain nem a interrupção
+    for (uint channel = 0; channel < NUM_DMA_CHANNELS; channel++)
+    {
+        if (abort & (1u << channel))
+        {
+            channels[channel].busy = false;
+        }
+    }
+    dma_regs.abort = 0;
+}
+
+// ==================== API do SDK ====================
+
+int dma_claim_unused_channel(bool required)
+{
+    (void)required;
+    for (uint channel = 0; channel < NUM_DMA_CHANNELS; channel++)
+    {
+        if (!channels[channel].claimed)
+        {
+            memset(&channels[channel], 0, sizeof(channels[channel]));
+            channels[channel].claimed = true;
+            return (int)channel;
+        }
+    }
+    return -1;
+}
+
+void dma_channel_unclaim(uint channel)
+{
+    channels[channel].claimed = false;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel)
+{
+    dma_channel_config c = {
+        .size = DMA_SIZE_32,
+        .read_increment = true,
+        .write_increment = false,
+        .dreq = DREQ_FORCE,
+        .chain_to = (uint8_t)channel,
+        .irq_quiet = false,
+    };
+    return c;
+}
+
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size)
+{
+    c->size = (uint8_t)size;
+}
+
+void channel_config_set_read_increment(dma_channel_config *c, bool incr)
+{
+    c->read_increment = incr;
+}
+
+void channel_config_set_write_increment(dma_channel_config *c, bool incr)
+{
+    c->write_increment = incr;
+}
+
+void channel_config_set_dreq(dma_channel_config *c, uint dreq)
+{
+    c->dreq = (uint8_t)dreq;
+}
+
+void channel_config_set_chain_to(dma_channel_config *c, uint chain_to)
+{
+    c->chain_to = (uint8_t)chain_to;
+}
+
+void channel_config_set_irq_quiet(dma_channel_config *c, bool irq_quiet)
+{
+    c->irq_quiet = irq_quiet;
+}
+
+void channel_config_set_high_priority(dma_channel_config *c, bool high_priority)
+{
+    (void)c;
+    (void)high_priority;
+}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint transfer_count, bool trigger_now)
+{
+    MockDmaChannel *c = &channels[channel];
+    c->config = *config;
+    c->write_addr = write_addr;
+    c->read_addr = read_addr;
+    c->count = transfer_count;
+    if (trigger_now)
+    {
+        trigger(channel);
+    }
+}
+
+void dma_channel_set_write_addr(uint channel, volatile void *write_addr, bool trigger_now)
+{
+    channels[channel].write_addr = write_addr;
+    if (trigger_now)
+    {
+        trigger(channel);
+    }
+}
+
+void dma_channel_set_read_addr(uint channel, const volatile void *read_addr, bool trigger_now)
+{
+    channels[channel].read_addr = read_addr;
+    if (trigger_now)
+    {
+        trigger(channel);
+    }
+}
+
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger_now)
+{
+    channels[channel].count = trans_count;
+    if (trigger_now)
+    {
+        trigger(channel);
+    }
+}
+
+void dma_channel_transfer_from_buffer_now(uint channel, const volatile void *read_addr, uint32_t transfer_count)
+{
+    channels[channel].read_addr = read_addr;
+    channels[channel].count = transfer_count;
+    trigger(channel);
+}
+
+void dma_channel_start(uint channel)
+{
+    trigger(channel);
+}
+
+void dma_channel_abort(uint channel)
+{
+    channels[channel].busy = false;
+}
+
+bool dma_channel_is_busy(uint channel)
+{
+    return channels[channel].busy;
+}
+
+void dma_channel_wait_for_finish_blocking(uint channel)
+{
+    while (channels[channel].busy)
+    {
+        __wfe();
+    }
+}
+
+void dma_channel_set_irq0_enabled(uint channel, bool enabled)
+{
+    channels[channel].irq0_enabled = enabled;
+}
+
+void dma_channel_set_irq1_enabled(uint channel, bool enabled)
+{
+    channels[channel].irq1_enabled = enabled;
+}
+
+bool dma_channel_get_irq0_status(uint channel)
+{
+    return dma_regs.ints0 & (1u << channel);
+}
+
+bool dma_channel_get_irq1_status(uint channel)
+{
+    return dma_regs.ints1 & (1u << channel);
+}
+
+void dma_channel_acknowledge_irq0(uint channel)
+{
+    dma_regs.ints0 &= ~(1u << channel);
+}
+
+void dma_channel_acknowledge_irq1(uint channel)
+{
+    dma_regs.ints1 &= ~(1u << channel);
+}
@@ -0,0 +1,271 @@
+#include "pico_mock_internal.h"
+#include "pico_mock.h"
+#include "hardware/i2c.h"
+#include <stdio.h>
+#include <string.h>
+
+// Endereço de 7 bits do SSD1306 (ssd1306_conf.h)
+#define MOCK_SSD1306_ADDR 0x3C
+#define MOCK_SSD1306_COLUMNS 128
+#define MOCK_SSD1306_PAGES 8
+
+static i2c_hw_t i2c_regs[2];
+i2c_inst_t i2c0_inst = {&i2c_regs[0], false};
+i2c_inst_t i2c1_inst = {&i2c_regs[1], false};
+
+// Transação em andamento por controlador (bytes escritos em data_cmd até o STOP)
+static uint8_t pending[2][2048];
+static size_t pending_len[2];
+
+uint i2c_hw_index(i2c_inst_t *i2c)
+{
+    return i2c == i2c1 ? 1u : 0u;
+}
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate)
+{
+    memset(i2c->hw, 0, sizeof(*i2c->hw));
+    i2c->hw->status = I2C_IC_STATUS_TFE_BITS;
+    i2c->hw->enable = 1;
+    pending_len[i2c_hw_index(i2c)] = 0;
+    return baudrate;
+}
+
+static void deliver(uint8_t addr, const uint8_t *data, size_t len)
+{
+    if (addr == MOCK_SSD1306_ADDR)
+    {
+        mock_ssd1306_transaction(data, len);
+    }
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop)
+{
+    (void)i2c;
+    (void)nostop;
+    deliver(addr, src, len);
+    return (int)len;
+}
+
+bool mock_i2c_is_data_cmd(const volatile void *addr, i2c_hw_t **hw)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        if (addr == &i2c_regs[i].data_cmd)
+        {
+            *hw = &i2c_regs[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+void mock_i2c_push_word(i2c_hw_t *hw, uint32_t word)
+{
+    int index = hw == &i2c_regs[1] ? 1 : 0;
+    if (pending_len[index] < sizeof(pending[index]))
+    {
+        pending[index][pending_len[index]++] = (uint8_t)word;
+    }
+    if (word & I2C_IC_DATA_CMD_STOP_BITS)
+    {
+        deliver((uint8_t)hw->tar, pending[index], pending_len[index]);
+        pending_len[index] = 0;
+    }
+}
+
+// ==================== Modelo do SSD1306 ====================
+
+static uint8_t gddram[MOCK_SSD1306_PAGES][MOCK_SSD1306_COLUMNS];
+static uint32_t received_bytes = 0;
+
+// Ponteiro de escrita e janela dos modos horizontal e vertical
+static uint8_t addressing_mode = 2; // Página, o valor de reset
+static uint8_t column = 0, column_start = 0, column_end = MOCK_SSD1306_COLUMNS - 1;
+static uint8_t page = 0, page_start = 0, page_end = MOCK_SSD1306_PAGES - 1;
+
+// Comando com argumentos ainda chegando
+static uint8_t command[8];
+static uint8_t command_len = 0;
+static uint8_t command_args = 0;
+
+/**
+ * Argumentos que seguem cada comando de configuração
+ */
+static uint8_t command_arg_count(uint8_t cmd)
+{
+    switch (cmd)
+    {
+    case 0x20:
+    case 0x81:
+    case 0x8D:
+    case 0xA8:
+    case 0xD3:
+    case 0xD5:
+    case 0xD9:
+    case 0xDA:
+    case 0xDB:
+        return 1;
+    case 0x21:
+    case 0x22:
+    case 0xA3:
+        return 2;
+    case 0x29:
+    case 0x2A:
+        return 5;
+    case 0x26:
+    case 0x27:
+        return 6;
+    default:
+        return 0;
+    }
+}
+
+static void execute_command(void)
+{
+    uint8_t cmd = command[0];
+    switch (cmd)
+    {
+    case 0x20:
+        addressing_mode = command[1] & 0x03;
+        break;
+    case 0x21:
+        column_start = command[1] & 0x7F;
+        column_end = command[2] & 0x7F;
+        column = column_start;
+        break;
+    case 0x22:
+        page_start = command[1] & 0x07;
+        page_end = command[2] & 0x07;
+        page = page_start;
+        break;
+    default:
+        if (cmd <= 0x0F)
+        {
+            column = (column & 0xF0) | cmd;
+        }
+        else if (cmd <= 0x1F)
+        {
+            column = (uint8_t)(((cmd & 0x07) << 4) | (column & 0x0F));
+        }
+        else if (cmd >= 0xB0 && cmd <= 0xB7)
+        {
+            page = cmd & 0x07;
+        }
+        // Os demais comandos (contraste, orientação, scroll...) não mudam a RAM
+        break;
+    }
+}
+
+static void command_byte(uint8_t byte)
+{
+    command[command_len++] = byte;
+    if (command_len == 1)
+    {
+        command_args = command_arg_count(byte);
+    }
+    if (command_len > command_args)
+    {
+        execute_command();
+        command_len = 0;
+    }
+}
+
+/**
+ * Escreve um byte na RAM e avança o ponteiro como o controlador
+ */
+static void data_byte(uint8_t byte)
+{
+    gddram[page][column] = byte;
+
+    switch (addressing_mode)
+    {
+    case 0: // Horizontal: coluna, depois página, dentro da janela
+        if (column == column_end)
+        {
+            column = column_start;
+            page = page == page_end ? page_start : page + 1;
+        }
+        else
+        {
+            column = (column + 1) & 0x7F;
+        }
+        break;
+    case 1: // Vertical: página, depois coluna
+        if (page == page_end)
+        {
+            page = page_start;
+            column = column == column_end ? column_start : (column + 1) & 0x7F;
+        }
+        else
+        {
+            page = (page + 1) & 0x07;
+        }
+        break;
+    default: // Página: só a coluna anda, sem mudar de página
+        column = (column + 1) & 0x7F;
+        break;
+    }
+}
+
+/**
+ * Interpreta uma transação: bytes de controle (Co, D/C) seguidos de
+ * comandos ou dados
+ */
+void mock_ssd1306_transaction(const uint8_t *data, size_t len)
+{
+    received_bytes += (uint32_t)len;
+    size_t i = 0;
+    while (i < len)
+    {
+        uint8_t control = data[i++];
+        bool continuation = (control & 0x80) != 0; // Co: só um byte segue este controle
+        bool is_data = (control & 0x40) != 0;      // D/C
+
+        size_t end = continuation ? (i + 1 < len ? i + 1 : len) : len;
+        for (; i < end; i++)
+        {
+            if (is_data)
+            {
+                data_byte(data[i]);
+            }
+            else
+            {
+                command_byte(data[i]);
+            }
+        }
+    }
+}
+
+bool pico_mock_ssd1306_pixel(uint8_t x, uint8_t y)
+{
+    if (x >= MOCK_SSD1306_COLUMNS || y >= MOCK_SSD1306_PAGES * 8)
+    {
+        return false;
+    }
+    return (gddram[y / 8][x] >> (y % 8)) & 1;
+}
+
+uint32_t pico_mock_ssd1306_bytes(void)
+{
+    return received_bytes;
+}
+
+bool pico_mock_ssd1306_write_pbm(const char *path)
+{
+    FILE *file = fopen(path, "w");
+    if (!file)
+    {
+        return false;
+    }
+    fprintf(file, "P1\n%d %d\n", MOCK_SSD1306_COLUMNS, MOCK_SSD1306_PAGES * 8);
+    for (uint8_t y = 0; y < MOCK_SSD1306_PAGES * 8; y++)
+    {
+        for (uint8_t x = 0; x < MOCK_SSD1306_COLUMNS; x++)
+        {
+            fputc(pico_mock_ssd1306_pixel(x, y) ? '1' : '0', file);
+        }
+        fputc('\n', file);
+    }
+    return fclose(file) == 0;
+}
@@ -0,0 +1,280 @@
+#include "pico_mock.h"
+#include "pico_mock_internal.h"
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include "hardware/sync.h"
+#include "hardware/irq.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+#include <time.h>
+
+#define MOCK_IRQ_COUNT 32
+#define MOCK_IRQ_HANDLERS 4
+#define MOCK_GPIO_COUNT 30
+
+// Espera sem nada em andamento: o tempo anda em passos de 1 ms
+#define MOCK_IDLE_STEP_US 1000
+
+static uint64_t now_us = 0;
+
+// ==================== Tempo virtual ====================
+
+uint64_t mock_now_us(void)
+{
+    return now_us;
+}
+
+void mock_set_now_us(uint64_t us)
+{
+    if (us > now_us)
+    {
+        now_us = us;
+    }
+}
+
+void pico_mock_advance_us(uint64_t us)
+{
+    uint64_t target = now_us + us;
+    mock_dma_poll();
+    mock_dma_run_until(target);
+    mock_set_now_us(target);
+}
+
+uint64_t time_us_64(void)
+{
+    return now_us;
+}
+
+uint32_t time_us_32(void)
+{
+    return (uint32_t)now_us;
+}
+
+absolute_time_t get_absolute_time(void)
+{
+    return now_us;
+}
+
+uint32_t to_ms_since_boot(absolute_time_t t)
+{
+    return (uint32_t)(t / 1000u);
+}
+
+uint64_t to_us_since_boot(absolute_time_t t)
+{
+    return t;
+}
+
+absolute_time_t make_timeout_time_ms(uint32_t ms)
+{
+    return now_us + (uint64_t)ms * 1000u;
+}
+
+absolute_time_t delayed_by_ms(absolute_time_t t, uint32_t ms)
+{
+    return t + (uint64_t)ms * 1000u;
+}
+
+absolute_time_t delayed_by_us(absolute_time_t t, uint64_t us)
+{
+    return t + us;
+}
+
+int64_t absolute_time_diff_us(absolute_time_t from, absolute_time_t to)
+{
+    return (int64_t)(to - from);
+}
+
+void sleep_us(uint64_t us)
+{
+    pico_mock_advance_us(us);
+}
+
+void sleep_ms(uint32_t ms)
+{
+    pico_mock_advance_us((uint64_t)ms * 1000u);
+}
+
+void busy_wait_us(uint64_t us)
+{
+    pico_mock_advance_us(us);
+}
+
+void tight_loop_contents(void)
+{
+    pico_mock_advance_us(1);
+}
+
+void __wfe(void)
+{
+    mock_dma_poll();
+    uint64_t next;
+    if (!mock_dma_next_event_us(&next) || next <= now_us)
+    {
+        next = now_us + MOCK_IDLE_STEP_US;
+    }
+    mock_dma_run_until(next);
+    mock_set_now_us(next);
+}
+
+void __wfi(void)
+{
+    __wfe();
+}
+
+// ==================== SysTick e clocks ====================
+
+static systick_hw_t systick_regs;
+
+systick_hw_t *pico_mock_systick(void)
+{
+    // Conta para baixo em 24 bits, um passo por nanossegundo do host
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t ns = (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+    systick_regs.cvr = (uint32_t)(~ns) & 0x00FFFFFFu;
+    return &systick_regs;
+}
+
+uint32_t clock_get_hz(enum clock_index clock)
+{
+    switch (clock)
+    {
+    case clk_sys:
+        return 1000000000u;
+    case clk_adc:
+        return 48000000u;
+    default:
+        return 12000000u;
+    }
+}
+
+// ==================== Interrupções ====================
+
+static irq_handler_t irq_handlers[MOCK_IRQ_COUNT][MOCK_IRQ_HANDLERS];
+static bool irq_enabled[MOCK_IRQ_COUNT];
+
+void irq_set_exclusive_handler(uint num, irq_handler_t handler)
+{
+    if (num < MOCK_IRQ_COUNT)
+    {
+        irq_handlers[num][0] = handler;
+    }
+}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority)
+{
+    (void)order_priority;
+    if (num >= MOCK_IRQ_COUNT)
+    {
+        return;
+    }
+    for (int h = 0; h < MOCK_IRQ_HANDLERS; h++)
+    {
+        if (!irq_handlers[num][h])
+        {
+            irq_handlers[num][h] = handler;
+            return;
+        }
+    }
+}
+
+void irq_remove_handler(uint num, irq_handler_t handler)
+{
+    if (num >= MOCK_IRQ_COUNT)
+    {
+        return;
+    }
+    for (int h = 0; h < MOCK_IRQ_HANDLERS; h++)
+    {
+        if (irq_handlers[num][h] == handler)
+        {
+            irq_handlers[num][h] = NULL;
+        }
+    }
+}
+
+void irq_set_enabled(uint num, bool enabled)
+{
+    if (num < MOCK_IRQ_COUNT)
+    {
+        irq_enabled[num] = enabled;
+    }
+}
+
+void irq_set_priority(uint num, uint8_t priority)
+{
+    (void)num;
+    (void)priority;
+}
+
+void mock_irq_raise(uint num)
+{
+    if (num >= MOCK_IRQ_COUNT || !irq_enabled[num])
+    {
+        return;
+    }
+    for (int h = 0; h < MOCK_IRQ_HANDLERS; h++)
+    {
+        if (irq_handlers[num][h])
+        {
+            irq_handlers[num][h]();
+        }
+    }
+}
+
+// ==================== GPIO e stdio ====================
+
+static bool gpio_level[MOCK_GPIO_COUNT];
+
+void gpio_init(uint gpio)
+{
+    if (gpio < MOCK_GPIO_COUNT)
+    {
+        gpio_level[gpio] = false;
+    }
+}
+
+void gpio_set_dir(uint gpio, bool out)
+{
+    (void)gpio;
+    (void)out;
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn)
+{
+    (void)gpio;
+    (void)fn;
+}
+
+void gpio_pull_up(uint gpio)
+{
+    if (gpio < MOCK_GPIO_COUNT)
+    {
+        gpio_level[gpio] = true;
+    }
+}
+
+void gpio_put(uint gpio, bool value)
+{
+    if (gpio < MOCK_GPIO_COUNT)
+    {
+        gpio_level[gpio] = value;
+    }
+}
+
+bool gpio_get(uint gpio)
+{
+    return gpio < MOCK_GPIO_COUNT && gpio_level[gpio];
+}
+
+bool stdio_init_all(void)
+{
+    return true;
+}
+
+int getchar_timeout_us(uint32_t timeout_us)
+{
+    pico_mock_advance_us(timeout_us);
+    return PICO_ERROR_TIMEOUT;
+}
@@ -0,0 +1,35 @@
+#ifndef PICO_MOCK_INTERNAL_H
+#define PICO_MOCK_INTERNAL_H
+#include <stdint.h>
+#include <stddef.h>
+#include "pico/types.h"
+#include "hardware/i2c.h"
+
+// Ligações entre as partes do hardware simulado (não fazem parte do SDK)
+
+// Tempo virtual atual
+uint64_t mock_now_us(void);
+void mock_set_now_us(uint64_t us);
+
+// DMA: executa as transferências com ritmo até o instante dado e trata os aborts
+void mock_dma_run_until(uint64_t us);
+bool mock_dma_next_event_us(uint64_t *us);
+void mock_dma_poll(void);
+
+// ADC: amostras convertidas até um instante e instante de uma amostra
+bool mock_adc_running(void);
+uint64_t mock_adc_samples_at(uint64_t us);
+uint64_t mock_adc_sample_time_us(uint64_t sample);
+uint16_t mock_adc_code(uint64_t sample);
+
+// Interrupções
+void mock_irq_raise(uint num);
+
+// I2C: uma palavra escrita em data_cmd (bits 0..7 = byte, bit STOP fecha a transação)
+void mock_i2c_push_word(i2c_hw_t *hw, uint32_t word);
+bool mock_i2c_is_data_cmd(const volatile void *addr, i2c_hw_t **hw);
+
+// Display: uma transação I2C completa para o endereço do SSD1306
+void mock_ssd1306_transaction(const uint8_t *data, size_t len);
+
+#endif // PICO_MOCK_INTERNAL_H
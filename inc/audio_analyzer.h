@@ -1,6 +1,11 @@
 #ifndef AUDIO_ANALYZER_H
 #define AUDIO_ANALYZER_H
 #include <stdbool.h>
+#include <stdint.h>
+#include "fixed_point.h"
+#include "sound_level.h"
+#include "band_filter.h"
+#include "drivers/mic/mic.h"
 
 /** 
  * @brief Limite inferior de volume 
@@ -40,10 +45,18 @@
 
 /** 
  * @brief Tamanho do histórico de volume 
- * Número de amostras mantidas para análise histórica 
+ * Número de entradas mantidas em cada resolução do histórico
+ * (ver audio_history.h)
  */
 #define HISTORY_SIZE 64
 
+/** 
+ * @brief Período de análise 
+ * Duração, em milissegundos, de cada resultado produzido a partir
+ * da captura contínua (mesmo intervalo de atualização do display)
+ */
+#define ANALYSIS_PERIOD_MS 50
+
 /**
  * @brief Estrutura de análise de áudio
  * 
@@ -58,26 +71,56 @@ typedef struct
     bool is_clipping;   ///< Flag de saturação do sinal
     bool is_low_volume; ///< Flag de volume baixo
     float noise_floor;  ///< Nível de ruído de fundo
+    float weighted_db[SOUND_WEIGHTING_COUNT][SOUND_TIME_COUNT]; ///< Níveis ponderados em dB
 } AudioAnalysis;
 
+/**
+ * @brief Estrutura de análise de áudio em ponto fixo
+ * 
+ * Mesmo conteúdo de AudioAnalysis, com todos os valores em Q15.16.
+ * É o resultado nativo da análise; AudioAnalysis é apenas uma
+ * visão em float para o display.
+ */
+typedef struct
+{
+    fx_q16_t voltage;      ///< Tensão RMS (AC) do microfone com ganho, em volts
+    fx_q16_t rms_value;    ///< Valor RMS do sinal com ganho, em códigos do ADC
+    fx_q16_t estimated_db; ///< Estimativa de nível em decibéis
+    bool is_clipping;      ///< Flag de saturação do sinal
+    bool is_low_volume;    ///< Flag de volume baixo
+    fx_q16_t noise_floor;  ///< Nível de ruído de fundo, em volts
+    SoundLevels levels;    ///< Níveis ponderados A/C com Fast/Slow/Impulse, no fim do período
+    BandLevels bands;      ///< Níveis por banda de oitava ou 1/3 de oitava, no período
+} AudioAnalysisFx;
+
 /**
  * @brief Inicializa o histórico de áudio
  * 
  * Prepara as estruturas de dados para armazenamento 
- * do histórico de análise de áudio
+ * do histórico de análise de áudio, com todos os níveis vazios
+ * e o ruído de fundo reiniciado
  */
 void init_audio_history(void);
 
 /**
  * @brief Calcula o nível de ruído de fundo
  * 
- * Determina o nível de ruído ambiente baseado no sinal atual
+ * Determina o nível de ruído ambiente pelo mínimo da potência
+ * suavizada em uma janela deslizante (ver noise_floor.h)
  * 
  * @param current_voltage Tensão atual do sinal de áudio
  * @return float Nível estimado de ruído de fundo
  */
 float calculate_noise_floor(float current_voltage);
 
+/**
+ * @brief Calcula o nível de ruído de fundo em ponto fixo
+ * 
+ * @param current_voltage Tensão atual do sinal de áudio em Q15.16
+ * @return fx_q16_t Nível estimado de ruído de fundo em Q15.16
+ */
+fx_q16_t calculate_noise_floor_fx(fx_q16_t current_voltage);
+
 /**
  * @brief Analisa o sinal de áudio
  * 
@@ -87,9 +130,44 @@ float calculate_noise_floor(float current_voltage);
  */
 AudioAnalysis analyze_audio(void);
 
-// Históricos para visualização
-extern float voltage_history[HISTORY_SIZE];      ///< Histórico de tensão
-extern float noise_floor_history[HISTORY_SIZE];  ///< Histórico de nível de ruído
-extern int history_index;                        ///< Índice atual no histórico
+/**
+ * @brief Analisa o sinal de áudio em ponto fixo
+ * 
+ * Caminho principal da análise, sem operações em float
+ * 
+ * @return AudioAnalysisFx Resultado da análise em Q15.16
+ */
+AudioAnalysisFx analyze_audio_fx(void);
+
+/**
+ * @brief Acumula um bloco da captura contínua
+ * 
+ * Soma a potência de todos os blocos do período de análise, então
+ * nenhuma amostra fica de fora. Ao completar ANALYSIS_PERIOD_MS de
+ * áudio, produz a análise do período. Não altera o histórico.
+ * 
+ * @param stats Estatísticas do bloco capturado
+ * @param result Saída com a análise do período, quando completo
+ * @return bool Verdadeiro se um período foi completado
+ */
+bool audio_analyzer_push_block(const MicBlockStats *stats, AudioAnalysisFx *result);
+
+/**
+ * @brief Converte o resultado em ponto fixo para a visão em float
+ * 
+ * @param analysis Resultado da análise em Q15.16
+ * @return AudioAnalysis Mesmo resultado em float
+ */
+AudioAnalysis audio_analysis_to_float(const AudioAnalysisFx *analysis);
+
+/**
+ * @brief Compara o custo do caminho em float com o de ponto fixo
+ * 
+ * Captura um bloco e processa o mesmo bloco pelos dois caminhos,
+ * medindo ciclos com o SysTick. O resultado é impresso no stdio.
+ * 
+ * @param iterations Número de repetições de cada caminho
+ */
+void audio_analyzer_benchmark(uint32_t iterations);
 
 #endif // AUDIO_ANALYZER_H
\ No newline at end of file
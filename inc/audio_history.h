@@ -0,0 +1,112 @@
+#ifndef AUDIO_HISTORY_H
+#define AUDIO_HISTORY_H
+#include <stdbool.h>
+#include <stdint.h>
+#include "audio_analyzer.h"
+
+/**
+ * @brief Resoluções do histórico, da mais fina para a mais grossa
+ *
+ * Cada nível guarda HISTORY_SIZE entradas. Uma entrada de um nível
+ * resume as entradas do nível anterior que cabem nela (20 blocos em
+ * 1 s, 60 s em 1 min, 60 min em 1 h; tabela history_level_ratio em
+ * audio_history.c).
+ */
+typedef enum
+{
+    HISTORY_LEVEL_BLOCK,  ///< Um resultado da análise (ANALYSIS_PERIOD_MS)
+    HISTORY_LEVEL_SECOND, ///< 1 s
+    HISTORY_LEVEL_MINUTE, ///< 1 min
+    HISTORY_LEVEL_HOUR,   ///< 1 h
+    HISTORY_LEVEL_COUNT   ///< Número de níveis
+} HistoryLevelId;
+
+/**
+ * @brief Código de tensão do histórico
+ * Uma unidade vale 1/4096 V (Q15.16 >> 4), então o código cabe em
+ * 16 bits até 16 V e a conversão é só um deslocamento
+ */
+typedef uint16_t history_code_t;
+
+#define HISTORY_CODE_SHIFT 4
+#define HISTORY_CODE_MAX 0xFFFF
+#define HISTORY_CODE_TO_FX(code) ((fx_q16_t)(code) << HISTORY_CODE_SHIFT)
+
+/**
+ * @brief Um nível do histórico, em struct-of-arrays
+ *
+ * Cada entrada tem mínimo, máximo e média da tensão e do ruído de
+ * fundo no intervalo que resume. No nível HISTORY_LEVEL_BLOCK os três
+ * valores são iguais. A entrada mais nova fica em index - 1.
+ */
+typedef struct
+{
+    history_code_t voltage_min[HISTORY_SIZE];  ///< Menor tensão do intervalo
+    history_code_t voltage_max[HISTORY_SIZE];  ///< Maior tensão do intervalo
+    history_code_t voltage_mean[HISTORY_SIZE]; ///< Tensão média do intervalo
+    history_code_t noise_min[HISTORY_SIZE];    ///< Menor ruído de fundo do intervalo
+    history_code_t noise_max[HISTORY_SIZE];    ///< Maior ruído de fundo do intervalo
+    history_code_t noise_mean[HISTORY_SIZE];   ///< Ruído de fundo médio do intervalo
+    uint8_t index;                             ///< Próxima posição a escrever
+    uint32_t count;                            ///< Entradas fechadas desde o início
+} HistoryLevel;
+
+/**
+ * @brief Limpa todos os níveis do histórico
+ */
+void audio_history_init(void);
+
+/**
+ * @brief Armazena um resultado no histórico de visualização
+ *
+ * O resultado entra no nível mais fino e é acumulado no intervalo
+ * aberto dos demais. Um intervalo só é resumido quando fecha, então
+ * o custo por resultado é O(1) amortizado.
+ *
+ * @param analysis Resultado da análise em Q15.16
+ */
+void audio_history_push(const AudioAnalysisFx *analysis);
+
+/**
+ * @brief Acessa um nível do histórico (somente leitura)
+ *
+ * @param level Nível desejado
+ * @return const HistoryLevel* Nível
+ */
+const HistoryLevel *audio_history_level(HistoryLevelId level);
+
+/**
+ * @brief Duração de uma entrada de um nível
+ *
+ * @param level Nível desejado
+ * @return uint32_t Duração em milissegundos
+ */
+uint32_t audio_history_period_ms(HistoryLevelId level);
+
+/**
+ * @brief Número de entradas preenchidas de um nível
+ *
+ * @param history Nível
+ * @return uint8_t Entre 0 e HISTORY_SIZE
+ */
+static inline uint8_t audio_history_filled(const HistoryLevel *history)
+{
+    return history->count < HISTORY_SIZE ? (uint8_t)history->count : HISTORY_SIZE;
+}
+
+/**
+ * @brief Posição da entrada i da janela, da mais antiga (0) para a mais nova
+ *
+ * As posições i < HISTORY_SIZE - audio_history_filled() ainda não
+ * foram preenchidas.
+ *
+ * @param history Nível
+ * @param i Índice na janela, de 0 a HISTORY_SIZE - 1
+ * @return int Posição nos vetores do nível
+ */
+static inline int audio_history_slot(const HistoryLevel *history, int i)
+{
+    return (history->index + i) % HISTORY_SIZE;
+}
+
+#endif // AUDIO_HISTORY_H
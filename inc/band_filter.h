@@ -0,0 +1,101 @@
+#ifndef BAND_FILTER_H
+#define BAND_FILTER_H
+#include <stdbool.h>
+#include <stdint.h>
+#include "fixed_point.h"
+
+/**
+ * @brief Maior número de bandas
+ * 1/3 de oitava de 31,5 Hz a 20 kHz; com o ADC a 48 kHz, a última
+ * banda que cabe abaixo de Nyquist é a de 20 kHz
+ */
+#define BAND_FILTER_MAX_BANDS 29
+
+/**
+ * @brief Maior número de estágios de decimação
+ * Cada estágio roda na metade da taxa do anterior
+ */
+#define BAND_FILTER_MAX_STAGES 10
+
+/**
+ * @brief Resolução do banco de filtros
+ */
+typedef enum
+{
+    BAND_FILTER_OCTAVE,      ///< Bandas de oitava (31,5 Hz, 63 Hz, ... 16 kHz)
+    BAND_FILTER_THIRD_OCTAVE ///< Bandas de 1/3 de oitava (31,5 Hz, 40 Hz, ... 20 kHz)
+} BandFilterMode;
+
+/**
+ * @brief Resolução usada pelo núcleo de DSP
+ * 1/3 de oitava custa cerca do dobro das oitavas por amostra
+ */
+#define BAND_FILTER_DEFAULT_MODE BAND_FILTER_OCTAVE
+
+/**
+ * @brief Níveis por banda, em dB (Q15.16)
+ *
+ * Mesma referência de estimated_db, sem ponderação em frequência (Z).
+ * Cada nível é o equivalente do período desde a leitura anterior.
+ */
+typedef struct
+{
+    fx_q16_t db[BAND_FILTER_MAX_BANDS]; ///< Nível de cada banda, da mais grave para a mais aguda
+    uint8_t count;                      ///< Bandas válidas
+    uint8_t mode;                       ///< BandFilterMode que produziu os níveis
+} BandLevels;
+
+/**
+ * @brief Monta o banco de filtros para a taxa do ADC
+ *
+ * Cada banda fica no estágio mais decimado em que ainda cabe com folga
+ * para o filtro anti-aliasing; as bandas acima de Nyquist ficam de fora.
+ * Os coeficientes são calculados uma vez, em float; o processamento é
+ * todo em inteiros.
+ *
+ * @param mode Oitava ou 1/3 de oitava
+ */
+void band_filter_init(BandFilterMode mode);
+
+/**
+ * @brief Zera o estado dos filtros e das somas, mantendo o modo atual
+ */
+void band_filter_reset(void);
+
+/**
+ * @brief Passa um bloco da captura pelo banco de filtros
+ *
+ * As bandas de cada estágio são filtradas e o bloco segue, filtrado e
+ * decimado por 2, para o estágio seguinte. Como cada estágio recebe
+ * metade das amostras do anterior, o custo por amostra de entrada fica
+ * perto do custo do primeiro estágio, qualquer que seja o número de
+ * oitavas.
+ *
+ * @param samples Amostras de 12 bits do ADC
+ * @param count Número de amostras
+ */
+void band_filter_process(const uint16_t *samples, uint32_t count);
+
+/**
+ * @brief Lê os níveis das bandas e fecha o período
+ *
+ * @param levels Estrutura de saída
+ */
+void band_filter_get(BandLevels *levels);
+
+/**
+ * @brief Número de bandas do modo atual
+ *
+ * @return uint8_t Bandas abaixo de Nyquist
+ */
+uint8_t band_filter_get_count(void);
+
+/**
+ * @brief Frequência central exata de uma banda (base 2, 1 kHz de referência)
+ *
+ * @param band Índice da banda
+ * @return uint32_t Frequência em Hz
+ */
+uint32_t band_filter_center_hz(uint8_t band);
+
+#endif // BAND_FILTER_H
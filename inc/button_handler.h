@@ -1,25 +1,88 @@
 #ifndef BUTTON_HANDLER_H
 #define BUTTON_HANDLER_H
 #include <stdbool.h>
+#include <stdint.h>
 #include "pico/stdlib.h"
 
+/**
+ * @brief Tempo de estabilização depois de uma borda, em milissegundos
+ */
+#define BUTTON_DEBOUNCE_MS 20
+
+/**
+ * @brief Tempo pressionado para um toque longo, em milissegundos
+ */
+#define BUTTON_LONG_PRESS_MS 600
+
+/**
+ * @brief Intervalo máximo entre dois toques de um toque duplo, em milissegundos
+ * Um toque curto só é confirmado depois desse intervalo sem segundo toque
+ */
+#define BUTTON_DOUBLE_CLICK_MS 250
+
+/**
+ * @brief Capacidade da fila de eventos (potência de 2)
+ */
+#define BUTTON_EVENT_QUEUE_SIZE 8
+
+/**
+ * @brief Botões da placa
+ */
+typedef enum
+{
+    BUTTON_A,    ///< Botão A (GPIO 5 na BitDogLab)
+    BUTTON_B,    ///< Botão B (GPIO 6 na BitDogLab)
+    BUTTON_COUNT ///< Número de botões
+} ButtonId;
+
+/**
+ * @brief Gestos reconhecidos
+ */
+typedef enum
+{
+    BUTTON_GESTURE_SHORT,  ///< Toque curto, sem segundo toque em seguida
+    BUTTON_GESTURE_LONG,   ///< Pressionado por BUTTON_LONG_PRESS_MS (sai sem esperar soltar)
+    BUTTON_GESTURE_DOUBLE, ///< Dois toques curtos seguidos
+} ButtonGesture;
+
+/**
+ * @brief Evento de um botão
+ */
+typedef struct
+{
+    uint8_t button;   ///< ButtonId
+    uint8_t gesture;  ///< ButtonGesture
+    uint32_t time_ms; ///< Instante do reconhecimento, desde o boot
+} ButtonEvent;
+
 /**
  * @brief Inicializa um pino de botão
- * 
- * Configura o pino GPIO especificado como entrada para um botão,
- * aplicando as configurações necessárias como pull-up/pull-down.
- * 
+ *
+ * Configura o pino como entrada com pull-up e habilita a interrupção
+ * das duas bordas. Cada borda abre uma janela de BUTTON_DEBOUNCE_MS,
+ * medida por um alarme, e o nível é lido de novo no fim dela; os gestos
+ * são reconhecidos na própria interrupção e entram na fila de eventos.
+ *
+ * @param button Botão lógico
  * @param button_pin Número do pino GPIO do botão
  */
-void init_button(uint button_pin);
+void init_button(ButtonId button, uint button_pin);
+
+/**
+ * @brief Retira o próximo evento de botão
+ *
+ * Deve ser chamada pelo laço principal do núcleo que chamou init_button().
+ *
+ * @param event Destino do evento
+ * @return bool Falso se não há evento
+ */
+bool button_get_event(ButtonEvent *event);
 
 /**
- * @brief Verifica o estado atual do botão
- * 
- * Lê o estado do botão e retorna se foi pressionado.
- * 
- * @return bool Verdadeiro se o botão foi pressionado, falso caso contrário
+ * @brief Eventos perdidos por fila cheia
+ *
+ * @return uint32_t Total desde o boot
  */
-bool check_button(void);
+uint32_t button_get_dropped(void);
 
-#endif // BUTTON_HANDLER_H
\ No newline at end of file
+#endif // BUTTON_HANDLER_H
@@ -0,0 +1,50 @@
+#ifndef CYCLE_COUNTER_H
+#define CYCLE_COUNTER_H
+#include <stdint.h>
+#include "hardware/structs/systick.h"
+
+/**
+ * @brief Máscara do contador do SysTick
+ * O SysTick conta ciclos do processador para baixo, em 24 bits
+ * (~134 ms a 125 MHz antes de dar a volta).
+ */
+#define CYCLE_COUNTER_MASK 0x00FFFFFFu
+
+/**
+ * @brief Liga o SysTick como contador livre de ciclos
+ *
+ * Usa o clock do processador, sem interrupção. Pode ser chamada
+ * mais de uma vez.
+ */
+static inline void cycle_counter_init(void)
+{
+    if (!(systick_hw->csr & M0PLUS_SYST_CSR_ENABLE_BITS))
+    {
+        systick_hw->rvr = CYCLE_COUNTER_MASK;
+        systick_hw->cvr = 0;
+        systick_hw->csr = M0PLUS_SYST_CSR_ENABLE_BITS | M0PLUS_SYST_CSR_CLKSOURCE_BITS;
+    }
+}
+
+/**
+ * @brief Lê o valor atual do contador
+ *
+ * @return uint32_t Marca de tempo para cycle_counter_elapsed()
+ */
+static inline uint32_t cycle_counter_now(void)
+{
+    return systick_hw->cvr;
+}
+
+/**
+ * @brief Ciclos decorridos desde uma marca
+ *
+ * @param start Marca obtida com cycle_counter_now()
+ * @return uint32_t Ciclos decorridos (intervalos menores que 2^24 ciclos)
+ */
+static inline uint32_t cycle_counter_elapsed(uint32_t start)
+{
+    return (start - systick_hw->cvr) & CYCLE_COUNTER_MASK;
+}
+
+#endif // CYCLE_COUNTER_H
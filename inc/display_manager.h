@@ -1,17 +1,59 @@
 #ifndef DISPLAY_MANAGER_H
 #define DISPLAY_MANAGER_H
+#include <stdbool.h>
 #include "audio_analyzer.h"
 
+/**
+ * @brief Telas disponíveis
+ * 
+ * O botão percorre as telas nesta ordem; no gráfico, passa antes
+ * pelas resoluções do histórico.
+ */
+typedef enum
+{
+    DISPLAY_MODE_GRAPH,    ///< Gráfico histórico de volume e ruído
+    DISPLAY_MODE_MONITOR,  ///< Monitor de nível com status
+    DISPLAY_MODE_SPECTRUM, ///< Espectro em barras
+    DISPLAY_MODE_BANDS,    ///< Níveis por banda de oitava ou 1/3 de oitava
+    DISPLAY_MODE_COUNT     ///< Número de telas
+} DisplayMode;
+
 /**
  * @brief Exibe o monitor de áudio com os resultados da análise.
  * 
- * Esta função processa e mostra os resultados da análise de áudio 
- * na matriz de LEDs ou em outro meio de exibição.
+ * Esta função processa e desenha os resultados da análise de áudio 
+ * no framebuffer; display_flush() os envia ao display.
  * 
  * @param analysis Estrutura contendo os resultados da análise de áudio
  */
 void display_audio_monitor(AudioAnalysis analysis);
 
+/**
+ * @brief Escolhe a ponderação no tempo do nível do monitor.
+ * 
+ * O monitor mostra o nível em dB(A) com Fast (padrão), Slow ou Impulse.
+ * 
+ * @param weighting Ponderação no tempo
+ */
+void display_set_time_weighting(SoundTimeWeighting weighting);
+
+/**
+ * @brief Ponderação no tempo usada pelo monitor.
+ * 
+ * @return SoundTimeWeighting Ponderação atual
+ */
+SoundTimeWeighting display_get_time_weighting(void);
+
+/**
+ * @brief Indica no monitor um tom detectado.
+ * 
+ * O status do monitor mostra a frequência do tom enquanto ele durar
+ * (o aviso de volume alto tem prioridade).
+ * 
+ * @param frequency_hz Frequência do tom, ou 0 quando não há tom
+ */
+void display_set_tone(uint32_t frequency_hz);
+
 /**
  * @brief Desenha um gráfico de volume na matriz de LEDs.
  * 
@@ -20,4 +62,50 @@ void display_audio_monitor(AudioAnalysis analysis);
  */
 void display_volume_graph(void);
 
+/**
+ * @brief Passa o gráfico para a próxima resolução do histórico.
+ * 
+ * Percorre as janelas de 3 s, 64 s, 64 min e 64 h e, depois da
+ * última, volta à de 3 s. Cada resolução já está agregada no
+ * histórico, então a troca não relê dados brutos.
+ */
+void display_graph_next_scale(void);
+
+/**
+ * @brief Desenha o espectro do último quadro da FFT em barras.
+ * 
+ * Agrupa as raias em bandas de largura logarítmica e mostra o nível
+ * de cada banda em escala de dB, junto com a carga da FFT em relação
+ * ao orçamento de ciclos por quadro.
+ */
+void display_spectrum(void);
+
+/**
+ * @brief Desenha os níveis das bandas em barras.
+ * 
+ * Uma barra por banda, da mais grave à mais aguda, em dB na escala de
+ * estimated_db, com as frequências das bandas das pontas e de 1 kHz.
+ * 
+ * @param bands Níveis do último período
+ */
+void display_bands(const BandLevels *bands);
+
+/**
+ * @brief Envia ao display o quadro desenhado.
+ * 
+ * As funções display_* de cada tela só desenham no framebuffer; esta
+ * envia por DMA as janelas alteradas desde o último envio.
+ */
+void display_flush(void);
+
+/**
+ * @brief Mede as primitivas de desenho do display.
+ * 
+ * Desenha as mesmas formas pixel a pixel e pelos caminhos por bytes
+ * do driver, e imprime os ciclos de cada um. Apaga o framebuffer.
+ * 
+ * @param iterations Número de repetições de cada primitiva
+ */
+void display_benchmark(uint32_t iterations);
+
 #endif // DISPLAY_MANAGER_H
\ No newline at end of file
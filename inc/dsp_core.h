@@ -0,0 +1,67 @@
+#ifndef DSP_CORE_H
+#define DSP_CORE_H
+#include <stdbool.h>
+#include <stdint.h>
+#include "audio_analyzer.h"
+
+/**
+ * @brief Capacidade da fila de resultados entre os núcleos
+ * Com um resultado a cada ANALYSIS_PERIOD_MS, 8 posições cobrem
+ * 400 ms de atraso do núcleo de interface
+ */
+#define DSP_RESULT_QUEUE_SIZE 8
+
+/**
+ * @brief Contadores de perda dos dois lados da divisão entre núcleos
+ *
+ * Com o display sob carga, blocks_dropped e results_dropped devem
+ * permanecer em zero: isso prova que nenhum bloco de áudio se perdeu.
+ */
+typedef struct
+{
+    // Núcleo 1 (aquisição e DSP)
+    uint32_t blocks_captured;   ///< Blocos completados pelo DMA
+    uint32_t blocks_dropped;    ///< Blocos sobrescritos antes de serem analisados
+    uint32_t spectrum_dropped;  ///< Quadros da FFT descartados
+    uint32_t results_published; ///< Resultados colocados na fila
+    uint32_t results_dropped;   ///< Resultados recusados por fila cheia
+
+    // Núcleo 0 (interface)
+    uint32_t results_received;  ///< Resultados retirados da fila
+    uint32_t results_coalesced; ///< Resultados que entraram no histórico sem render próprio
+} DspCoreCounters;
+
+/**
+ * @brief Inicia o núcleo 1 com a captura e a análise
+ *
+ * O núcleo 1 inicializa o microfone, a captura contínua e o histórico
+ * de áudio. Esta função só retorna depois disso, e a partir daí o
+ * histórico pertence ao núcleo 0.
+ */
+void dsp_core_start(void);
+
+/**
+ * @brief Retira o próximo resultado publicado pelo núcleo 1
+ *
+ * Deve ser chamada apenas pelo núcleo 0.
+ *
+ * @param analysis Destino do resultado
+ * @return bool Falso se não há resultado novo
+ */
+bool dsp_core_receive(AudioAnalysisFx *analysis);
+
+/**
+ * @brief Registra resultados consumidos sem render próprio
+ *
+ * @param count Número de resultados agrupados em um único quadro
+ */
+void dsp_core_note_coalesced(uint32_t count);
+
+/**
+ * @brief Lê os contadores de perda dos dois núcleos
+ *
+ * @param counters Estrutura de saída
+ */
+void dsp_core_get_counters(DspCoreCounters *counters);
+
+#endif // DSP_CORE_H
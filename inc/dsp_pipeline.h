@@ -0,0 +1,36 @@
+#ifndef DSP_PIPELINE_H
+#define DSP_PIPELINE_H
+#include <stdbool.h>
+#include <stdint.h>
+#include "audio_analyzer.h"
+
+/**
+ * @brief Recebe o resultado de um período de análise
+ *
+ * Chamada no meio do bloco, antes da FFT, para que o resultado saia
+ * sem esperar o espectro.
+ */
+typedef void (*DspResultHandler)(const AudioAnalysisFx *analysis);
+
+/**
+ * @brief Inicializa a captura e todos os estágios de DSP
+ *
+ * Microfone, sondas, espectro, ponderações, bandas, detectores de tom,
+ * captura contínua e histórico. A interrupção do DMA fica no núcleo
+ * que chama.
+ */
+void dsp_pipeline_init(void);
+
+/**
+ * @brief Espera o próximo bloco capturado e o processa inteiro
+ *
+ * Ponderações, bandas e tons amostra a amostra, análise do período
+ * (entregue a on_result quando completa) e o quadro da FFT que a
+ * captura tiver completado. É o corpo do laço do núcleo 1 (dsp_core.c)
+ * e do build do host.
+ *
+ * @param on_result Destino de cada resultado de período
+ */
+void dsp_pipeline_process_block(DspResultHandler on_result);
+
+#endif // DSP_PIPELINE_H
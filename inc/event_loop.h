@@ -0,0 +1,63 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Eventos do laço principal (núcleo 0)
+ */
+typedef enum
+{
+    EVENT_LOOP_DSP_RESULT, ///< O núcleo 1 publicou um resultado (fim de bloco do DMA analisado)
+    EVENT_LOOP_BUTTON,     ///< Um gesto de botão entrou na fila
+    EVENT_LOOP_TIMER,      ///< Chegou a liberação de uma tarefa periódica (scheduler.h)
+    EVENT_LOOP_COUNT       ///< Número de eventos
+} EventLoopEvent;
+
+/**
+ * @brief Máscara de um evento no retorno de event_loop_wait()
+ */
+#define EVENT_LOOP_MASK(event) (1u << (event))
+
+/**
+ * @brief Atividade do laço desde a leitura anterior
+ */
+typedef struct
+{
+    uint32_t elapsed_us; ///< Duração do período
+    uint32_t idle_us;    ///< Tempo dormindo em __wfe
+    uint32_t wakeups;    ///< Vezes que o núcleo acordou
+    uint32_t events;     ///< Eventos entregues (os repetidos antes da entrega contam uma vez)
+} EventLoopStats;
+
+/**
+ * @brief Sinaliza um evento e acorda o núcleo 0
+ *
+ * Pode ser chamada de qualquer núcleo e de interrupções. Cada evento é
+ * um sinalizador: posts repetidos antes de event_loop_wait() se juntam
+ * em uma única entrega, então quem trata o evento deve esvaziar a fila
+ * correspondente inteira.
+ *
+ * @param event Evento
+ */
+void event_loop_post(EventLoopEvent event);
+
+/**
+ * @brief Dorme até haver pelo menos um evento
+ *
+ * O núcleo fica em __wfe entre os eventos: acorda com qualquer
+ * interrupção dele e com o __sev de event_loop_post() no outro núcleo.
+ * Os sinalizadores são limpos antes do retorno.
+ *
+ * @return uint32_t Máscara dos eventos pendentes (EVENT_LOOP_MASK)
+ */
+uint32_t event_loop_wait(void);
+
+/**
+ * @brief Lê a atividade do laço e começa um novo período
+ *
+ * @param stats Estrutura de saída
+ */
+void event_loop_get_stats(EventLoopStats *stats);
+
+#endif // EVENT_LOOP_H
@@ -0,0 +1,92 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+#include <stdint.h>
+
+/**
+ * @brief Número em ponto fixo Q15.16
+ * Inteiro de 32 bits com sinal e 16 bits fracionários (1.0 = 65536).
+ * O Cortex-M0+ do RP2040 não tem FPU, então a análise usa este formato.
+ */
+typedef int32_t fx_q16_t;
+
+/**
+ * @brief Número em ponto fixo Q1.15
+ * Inteiro de 16 bits com sinal e 15 bits fracionários (faixa [-1, 1)).
+ */
+typedef int16_t q15_t;
+
+/** @brief 1.0 em Q15.16 */
+#define FX_ONE 65536
+
+/**
+ * @brief Converte uma constante em Q15.16
+ * Destinado a constantes: o compilador resolve a conta sem usar soft-float.
+ */
+#define FX_FROM_FLOAT(x) ((fx_q16_t)((x) * 65536.0 + ((x) >= 0 ? 0.5 : -0.5)))
+
+/** @brief Converte Q15.16 para float (apenas para exibição) */
+#define FX_TO_FLOAT(x) ((float)(x) * (1.0f / 65536.0f))
+
+/** @brief Converte um inteiro em Q15.16 */
+#define FX_FROM_INT(x) ((fx_q16_t)((x) * FX_ONE))
+
+/**
+ * @brief Multiplica dois valores Q15.16
+ *
+ * @param a Primeiro fator
+ * @param b Segundo fator
+ * @return fx_q16_t Produto em Q15.16
+ */
+static inline fx_q16_t fx_mul(fx_q16_t a, fx_q16_t b)
+{
+    return (fx_q16_t)(((int64_t)a * b) >> 16);
+}
+
+/**
+ * @brief Raiz quadrada inteira
+ *
+ * @param value Valor de entrada
+ * @return uint32_t Parte inteira de sqrt(value)
+ */
+uint32_t fx_isqrt(uint32_t value);
+
+/**
+ * @brief Logaritmo na base 2 de um inteiro
+ *
+ * Usa a posição do bit mais significativo e uma tabela de 33 pontos
+ * com interpolação linear para a mantissa (erro < 0,0002).
+ *
+ * @param value Valor de entrada (deve ser maior que zero)
+ * @return fx_q16_t log2(value) em Q15.16
+ */
+fx_q16_t fx_log2(uint32_t value);
+
+/**
+ * @brief Converte uma amplitude em decibéis
+ *
+ * @param amplitude Amplitude em Q15.16 (deve ser maior que zero)
+ * @return fx_q16_t 20 * log10(amplitude) em Q15.16
+ */
+fx_q16_t fx_amplitude_to_db(fx_q16_t amplitude);
+
+/**
+ * @brief Converte uma potência inteira em decibéis
+ *
+ * @param power Potência com frac_bits bits fracionários (deve ser maior que zero)
+ * @param frac_bits Bits fracionários de power
+ * @return fx_q16_t 10 * log10(power) em Q15.16
+ */
+fx_q16_t fx_power_to_db(uint64_t power, uint32_t frac_bits);
+
+/**
+ * @brief Converte um nível em decibéis em potência inteira
+ *
+ * Inverso de fx_power_to_db() com frac_bits = 0: usa 2^x com uma tabela
+ * de 33 pontos e interpolação linear para a parte fracionária.
+ *
+ * @param db Nível em Q15.16 (até 180 dB)
+ * @return uint64_t 10^(db/10), arredondado para baixo (0 para db < 0)
+ */
+uint64_t fx_db_to_power(fx_q16_t db);
+
+#endif // FIXED_POINT_H
@@ -0,0 +1,105 @@
+#ifndef LEVEL_STATS_H
+#define LEVEL_STATS_H
+#include <stdbool.h>
+#include <stdint.h>
+#include "fixed_point.h"
+#include "band_filter.h"
+
+/**
+ * @brief Faixa e resolução do histograma de níveis
+ * Níveis fora da faixa entram no primeiro ou no último intervalo
+ */
+#define LEVEL_STATS_MIN_DB 20
+#define LEVEL_STATS_MAX_DB 140
+#define LEVEL_STATS_BINS_PER_DB 10
+#define LEVEL_STATS_BINS ((LEVEL_STATS_MAX_DB - LEVEL_STATS_MIN_DB) * LEVEL_STATS_BINS_PER_DB)
+
+/**
+ * @brief Registros fechados guardados até serem lidos
+ */
+#define LEVEL_STATS_RECORD_QUEUE 8
+
+/**
+ * @brief Janelas de integração
+ *
+ * Cada janela fecha sozinha ao completar sua duração e recomeça vazia.
+ * As durações ficam na tabela level_stats_durations_ms de level_stats.c.
+ */
+typedef enum
+{
+    LEVEL_STATS_1_MIN,       ///< 1 min
+    LEVEL_STATS_15_MIN,      ///< 15 min
+    LEVEL_STATS_1_H,         ///< 1 h
+    LEVEL_STATS_WINDOW_COUNT ///< Número de janelas
+} LevelStatsWindow;
+
+/**
+ * @brief Estatísticas de uma janela (dB em Q15.16)
+ *
+ * Ln é o nível excedido em n% do tempo, lido do histograma com
+ * resolução de 1/LEVEL_STATS_BINS_PER_DB dB.
+ */
+typedef struct
+{
+    LevelStatsWindow window;                  ///< Janela que produziu o registro
+    uint32_t sequence;                        ///< Número da janela desde o início (0, 1, ...)
+    uint32_t samples;                         ///< Níveis que entraram na janela
+    fx_q16_t leq;                             ///< Nível equivalente (média de energia)
+    fx_q16_t lmax;                            ///< Maior nível
+    fx_q16_t lmin;                            ///< Menor nível
+    fx_q16_t l10;                             ///< Excedido em 10% do tempo
+    fx_q16_t l50;                             ///< Excedido em 50% do tempo
+    fx_q16_t l90;                             ///< Excedido em 90% do tempo
+    uint8_t band_count;                       ///< Bandas com nível equivalente
+    fx_q16_t band_leq[BAND_FILTER_MAX_BANDS]; ///< Nível equivalente de cada banda
+} LevelStatsRecord;
+
+/**
+ * @brief Zera todas as janelas e a fila de registros
+ */
+void level_stats_init(void);
+
+/**
+ * @brief Acrescenta um período de análise a todas as janelas
+ *
+ * O custo é O(1) por janela; só o fechamento percorre o histograma.
+ * Cada chamada vale ANALYSIS_PERIOD_MS.
+ *
+ * @param level_db Nível com ponderação no tempo (ex.: LAF), para Lmax, Lmin e Ln
+ * @param leq_db Nível equivalente do período, para o Leq
+ * @param bands Níveis das bandas no período, para o Leq de cada banda (ou NULL)
+ */
+void level_stats_push(fx_q16_t level_db, fx_q16_t leq_db, const BandLevels *bands);
+
+/**
+ * @brief Retira o registro fechado mais antigo
+ *
+ * @param record Destino do registro
+ * @return bool Falso se não há registro pendente
+ */
+bool level_stats_pop_record(LevelStatsRecord *record);
+
+/**
+ * @brief Estatísticas parciais da janela em andamento
+ *
+ * @param window Janela desejada
+ * @param record Destino; samples = 0 se a janela ainda está vazia
+ */
+void level_stats_get_current(LevelStatsWindow window, LevelStatsRecord *record);
+
+/**
+ * @brief Registros descartados por fila cheia
+ *
+ * @return uint32_t Total desde level_stats_init()
+ */
+uint32_t level_stats_get_dropped(void);
+
+/**
+ * @brief Duração de uma janela
+ *
+ * @param window Janela
+ * @return uint32_t Duração em milissegundos
+ */
+uint32_t level_stats_window_ms(LevelStatsWindow window);
+
+#endif // LEVEL_STATS_H
@@ -0,0 +1,72 @@
+#ifndef NOISE_FLOOR_H
+#define NOISE_FLOOR_H
+#include <stdbool.h>
+#include <stdint.h>
+#include "fixed_point.h"
+
+/**
+ * @brief Janela do mínimo
+ * Depois de uma mudança do ambiente, a estimativa converge em no máximo
+ * NOISE_FLOOR_WINDOW_MS mais a suavização (para cima); para baixo ela
+ * acompanha já na suavização
+ */
+#define NOISE_FLOOR_WINDOW_MS 5000
+
+/**
+ * @brief Sub-janelas da janela do mínimo
+ * Cada atualização custa O(1); só o fechamento de uma sub-janela
+ * percorre os NOISE_FLOOR_SUBWINDOWS mínimos guardados
+ */
+#define NOISE_FLOOR_SUBWINDOWS 8
+
+/**
+ * @brief Constante de tempo da suavização da potência, em milissegundos
+ */
+#define NOISE_FLOOR_SMOOTHING_MS 200
+
+/**
+ * @brief Estimador do ruído de fundo por estatística de mínimos
+ *
+ * Segue o mínimo da potência suavizada em uma janela deslizante de
+ * NOISE_FLOOR_WINDOW_MS, dividida em sub-janelas, e corrige o viés
+ * do mínimo para estimar a potência média do ruído.
+ */
+typedef struct
+{
+    uint32_t smoothed;                     ///< Potência suavizada, em Q24 de V^2
+    uint32_t subwindow_min;                ///< Mínimo da sub-janela em andamento
+    uint32_t window_min;                   ///< Mínimo das sub-janelas fechadas
+    uint32_t mins[NOISE_FLOOR_SUBWINDOWS]; ///< Mínimo de cada sub-janela fechada
+    uint32_t subwindow_length;             ///< Atualizações por sub-janela
+    uint32_t subwindow_count;              ///< Atualizações na sub-janela em andamento
+    int32_t smoothing;                     ///< Alfa da suavização (peso da nova potência), em Q16
+    int32_t bias;                          ///< Compensação do viés, em Q16
+    uint8_t slot;                          ///< Próxima posição de mins
+    uint8_t filled;                        ///< Sub-janelas fechadas válidas
+    bool started;                          ///< Já recebeu a primeira atualização
+} NoiseFloorTracker;
+
+/**
+ * @brief Prepara o estimador
+ *
+ * Os fatores dependem do intervalo entre atualizações e são calculados
+ * uma vez, em float. A compensação do viés usa os graus de liberdade
+ * da potência suavizada: as amostras de cada atualização vezes o número
+ * equivalente de atualizações na média da suavização.
+ *
+ * @param tracker Estimador
+ * @param period_ms Intervalo entre chamadas de noise_floor_update()
+ * @param samples_per_update Amostras de áudio na potência de cada atualização
+ */
+void noise_floor_init(NoiseFloorTracker *tracker, uint32_t period_ms, uint32_t samples_per_update);
+
+/**
+ * @brief Acrescenta um nível e devolve a estimativa atual
+ *
+ * @param tracker Estimador
+ * @param voltage Tensão RMS do período (Q15.16)
+ * @return fx_q16_t Ruído de fundo estimado, em volts (Q15.16), nunca acima do nível suavizado
+ */
+fx_q16_t noise_floor_update(NoiseFloorTracker *tracker, fx_q16_t voltage);
+
+#endif // NOISE_FLOOR_H
@@ -0,0 +1,101 @@
+#ifndef PROBE_H
+#define PROBE_H
+#include <stdint.h>
+#include "cycle_counter.h"
+
+/**
+ * @brief Pontos medidos no caminho crítico
+ */
+typedef enum
+{
+    PROBE_MIC_SAMPLE,           ///< mic_sample(), sem a espera pelo bloco (núcleo 1)
+    PROBE_DSP_BLOCK,            ///< Processamento de um bloco inteiro no núcleo 1
+    PROBE_ANALYZE_AUDIO,        ///< Análise de um período (audio_analyzer_push_block/analyze_audio)
+    PROBE_DISPLAY_GRAPH,        ///< display_volume_graph() (núcleo 0)
+    PROBE_DISPLAY_MONITOR,      ///< display_audio_monitor() (núcleo 0)
+    PROBE_SSD1306_UPDATE,       ///< ssd1306_UpdateScreen(), envio bloqueante
+    PROBE_SSD1306_UPDATE_ASYNC, ///< ssd1306_UpdateScreenAsync(), só a preparação do DMA
+    PROBE_COUNT                 ///< Número de pontos
+} ProbeId;
+
+/**
+ * @brief Faixas do histograma: a faixa k conta as durações de 2^k a 2^(k+1)-1 ciclos
+ * O SysTick tem 24 bits, então a última faixa começa em 2^23 ciclos (~65 ms a 128 MHz)
+ */
+#define PROBE_BUCKETS 24
+
+/**
+ * @brief Histograma e extremos de um ponto
+ */
+typedef struct
+{
+    uint32_t count;                  ///< Medições
+    uint32_t min_cycles;             ///< Menor duração
+    uint32_t max_cycles;             ///< Maior duração
+    uint64_t total_cycles;           ///< Soma das durações, para a média
+    uint32_t buckets[PROBE_BUCKETS]; ///< Medições por faixa de log2 dos ciclos
+} ProbeStats;
+
+#ifdef MIC_MONITOR_PROBES
+
+/**
+ * @brief Abre a medição de um ponto no escopo atual
+ *
+ * Declara a marca de início; PROBE_END com o mesmo ponto precisa estar
+ * no mesmo escopo. O contador é o SysTick do núcleo (cycle_counter.h),
+ * então cada núcleo precisa ter chamado probe_init().
+ */
+#define PROBE_BEGIN(id) const uint32_t probe_start_##id = cycle_counter_now()
+
+/**
+ * @brief Fecha a medição aberta por PROBE_BEGIN e guarda no histograma
+ */
+#define PROBE_END(id) probe_record((id), cycle_counter_elapsed(probe_start_##id))
+
+/**
+ * @brief Guarda uma duração no histograma de um ponto
+ *
+ * Cada ponto só pode ser medido por um núcleo.
+ *
+ * @param id Ponto
+ * @param cycles Duração em ciclos
+ */
+void probe_record(ProbeId id, uint32_t cycles);
+
+#else
+
+// Sem MIC_MONITOR_PROBES (builds de release) as medições não geram código
+#define PROBE_BEGIN(id) ((void)0)
+#define PROBE_END(id) ((void)0)
+
+#endif // MIC_MONITOR_PROBES
+
+/**
+ * @brief Liga o contador de ciclos do núcleo que chama
+ *
+ * Deve ser chamada uma vez em cada núcleo que tem pontos medidos.
+ */
+void probe_init(void);
+
+/**
+ * @brief Lê o histograma de um ponto
+ *
+ * A leitura de um ponto do outro núcleo não é atômica: uma medição
+ * simultânea pode aparecer só em parte dos campos.
+ *
+ * @param id Ponto
+ * @param stats Estrutura de saída (zerada sem MIC_MONITOR_PROBES)
+ */
+void probe_get(ProbeId id, ProbeStats *stats);
+
+/**
+ * @brief Imprime os histogramas no stdio (USB CDC)
+ */
+void probe_dump(void);
+
+/**
+ * @brief Zera todos os histogramas
+ */
+void probe_reset(void);
+
+#endif // PROBE_H
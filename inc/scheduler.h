@@ -0,0 +1,93 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Maior número de tarefas da tabela
+ */
+#define SCHEDULER_MAX_TASKS 8
+
+/**
+ * @brief Corpo de uma tarefa: roda até o fim, sem ceder no meio
+ */
+typedef void (*SchedulerTaskFn)(void);
+
+/**
+ * @brief Tarefa da tabela estática do escalonador
+ *
+ * Uma tarefa é liberada pelo período, por eventos do laço (event_loop.h)
+ * ou pelos dois. Entre as liberadas, roda primeiro a de menor prioridade
+ * numérica; no empate, a que vem antes na tabela. O prazo conta a
+ * partir da liberação até o fim da execução; para uma liberação por
+ * evento, a partir de quando o laço recebe o evento.
+ */
+typedef struct
+{
+    const char *name;     ///< Nome mostrado nas estatísticas
+    SchedulerTaskFn run;  ///< Corpo da tarefa
+    uint32_t period_ms;   ///< Período de liberação (0 = só por eventos)
+    uint32_t deadline_ms; ///< Prazo relativo à liberação
+    uint8_t priority;     ///< 0 é a mais urgente
+    uint32_t events;      ///< Eventos que liberam a tarefa (máscara de EVENT_LOOP_MASK)
+} SchedulerTask;
+
+/**
+ * @brief Tempos de execução de uma tarefa desde scheduler_init()
+ */
+typedef struct
+{
+    uint32_t runs;            ///< Execuções
+    uint32_t min_us;          ///< Menor tempo de execução
+    uint32_t avg_us;          ///< Tempo médio de execução
+    uint32_t max_us;          ///< Maior tempo de execução
+    uint32_t max_latency_us;  ///< Maior espera entre a liberação e o início
+    uint32_t deadline_misses; ///< Execuções que terminaram depois do prazo
+} SchedulerTaskStats;
+
+/**
+ * @brief Registra a tabela de tarefas
+ *
+ * A tabela precisa continuar válida. As tarefas periódicas são liberadas
+ * pela primeira vez logo na entrada de scheduler_run().
+ *
+ * @param tasks Tabela de tarefas
+ * @param count Número de tarefas (até SCHEDULER_MAX_TASKS)
+ */
+void scheduler_init(const SchedulerTask *tasks, uint8_t count);
+
+/**
+ * @brief Executa as tarefas para sempre
+ *
+ * Entre as execuções o núcleo dorme em event_loop_wait(); um alarme
+ * acorda o laço na próxima liberação periódica.
+ */
+void scheduler_run(void);
+
+/**
+ * @brief Número de tarefas registradas
+ *
+ * @return uint8_t Tarefas da tabela
+ */
+uint8_t scheduler_get_task_count(void);
+
+/**
+ * @brief Tarefa da tabela
+ *
+ * @param task Índice da tarefa
+ * @return const SchedulerTask* Tarefa, ou NULL se o índice é inválido
+ */
+const SchedulerTask *scheduler_get_task(uint8_t task);
+
+/**
+ * @brief Lê os tempos de uma tarefa
+ *
+ * Pode ser chamada por uma tarefa (as outras não rodam ao mesmo tempo).
+ *
+ * @param task Índice da tarefa
+ * @param stats Estrutura de saída
+ * @return bool Falso se o índice é inválido
+ */
+bool scheduler_get_stats(uint8_t task, SchedulerTaskStats *stats);
+
+#endif // SCHEDULER_H
@@ -0,0 +1,70 @@
+#ifndef SOUND_LEVEL_H
+#define SOUND_LEVEL_H
+#include <stdint.h>
+#include "fixed_point.h"
+
+/**
+ * @brief Ponderações em frequência (IEC 61672)
+ */
+typedef enum
+{
+    SOUND_WEIGHTING_A,    ///< Curva A
+    SOUND_WEIGHTING_C,    ///< Curva C
+    SOUND_WEIGHTING_COUNT ///< Número de ponderações
+} SoundFrequencyWeighting;
+
+/**
+ * @brief Ponderações no tempo (IEC 61672)
+ */
+typedef enum
+{
+    SOUND_TIME_FAST,    ///< Constante de 125 ms
+    SOUND_TIME_SLOW,    ///< Constante de 1 s
+    SOUND_TIME_IMPULSE, ///< 35 ms na subida, 1,5 s na descida
+    SOUND_TIME_COUNT    ///< Número de ponderações
+} SoundTimeWeighting;
+
+/**
+ * @brief Níveis ponderados, em dB (Q15.16)
+ *
+ * Mesma referência de estimated_db (20 * log10(V) + 100, com o ganho
+ * do microfone), então um tom de 1 kHz lê o mesmo valor nas duas
+ * ponderações em frequência.
+ */
+typedef struct
+{
+    fx_q16_t db[SOUND_WEIGHTING_COUNT][SOUND_TIME_COUNT]; ///< Nível por ponderação em frequência e no tempo
+    fx_q16_t leq_db[SOUND_WEIGHTING_COUNT];               ///< Nível equivalente desde a leitura anterior
+} SoundLevels;
+
+/**
+ * @brief Calcula os coeficientes dos filtros e zera o estado
+ *
+ * Os coeficientes dependem da taxa do ADC e são calculados uma vez,
+ * em float; o processamento é todo em inteiros.
+ */
+void sound_level_init(void);
+
+/**
+ * @brief Passa um bloco da captura pelas ponderações
+ *
+ * Cada amostra passa pela cascata das curvas C e A. Os integradores
+ * exponenciais avançam a cada SAMPLES amostras com a potência média do
+ * trecho, então os blocos podem ter qualquer tamanho.
+ *
+ * @param samples Amostras de 12 bits do ADC
+ * @param count Número de amostras
+ */
+void sound_level_process(const uint16_t *samples, uint32_t count);
+
+/**
+ * @brief Lê os níveis atuais dos integradores
+ *
+ * Também fecha o período do nível equivalente (leq_db): a próxima
+ * leitura cobre a energia acumulada a partir daqui.
+ *
+ * @param levels Estrutura de saída
+ */
+void sound_level_get(SoundLevels *levels);
+
+#endif // SOUND_LEVEL_H
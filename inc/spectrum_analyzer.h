@@ -0,0 +1,106 @@
+#ifndef SPECTRUM_ANALYZER_H
+#define SPECTRUM_ANALYZER_H
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Maior FFT suportada
+ * Dimensiona os buffers e a tabela de twiddles (256, 512 ou 1024 pontos)
+ */
+#define SPECTRUM_MAX_FFT_SIZE 1024
+
+/**
+ * @brief Tamanho padrão da FFT
+ * Número de amostras reais por quadro do espectro
+ */
+#define SPECTRUM_FFT_SIZE 1024
+
+/**
+ * @brief Estatísticas de processamento do espectro
+ *
+ * Permite verificar se a FFT acompanha a captura contínua: cada quadro
+ * precisa ser processado em menos de budget_cycles, que é o tempo que
+ * o ADC leva para encher o quadro seguinte.
+ */
+typedef struct
+{
+    uint32_t last_cycles;   ///< Ciclos gastos no último quadro
+    uint32_t max_cycles;    ///< Maior custo observado por quadro
+    uint32_t budget_cycles; ///< Ciclos disponíveis por quadro na taxa do ADC
+    uint32_t frames;        ///< Quadros processados
+    uint32_t dropped;       ///< Quadros descartados por não terem sido processados a tempo
+} SpectrumStats;
+
+/**
+ * @brief Inicializa o analisador de espectro
+ *
+ * Calcula a janela de Hann para o tamanho escolhido e zera o estado.
+ *
+ * @param fft_size Tamanho da FFT (256, 512 ou 1024)
+ * @return bool Verdadeiro se o tamanho é suportado
+ */
+bool spectrum_init(uint16_t fft_size);
+
+/**
+ * @brief Entrega amostras da captura ao montador de quadros
+ *
+ * Pode ser chamada a partir do callback de bloco do microfone
+ * (contexto de interrupção). Quando um quadro enche e o anterior
+ * ainda não foi processado, o novo quadro é descartado.
+ *
+ * @param samples Amostras de 12 bits do ADC
+ * @param count Número de amostras
+ */
+void spectrum_push_samples(const uint16_t *samples, uint32_t count);
+
+/**
+ * @brief Processa um quadro pendente
+ *
+ * Remove o DC, aplica a janela, executa a FFT real em ponto fixo
+ * e atualiza as magnitudes.
+ *
+ * @return bool Verdadeiro se um novo espectro foi calculado
+ */
+bool spectrum_process(void);
+
+/**
+ * @brief Executa a FFT real in-place sobre um quadro
+ *
+ * Motor da FFT, exposto para uso fora do fluxo de captura.
+ * O quadro é sobrescrito pelo resultado intermediário.
+ *
+ * @param frame Amostras já janeladas em Q15 (fft_size valores, alinhado em 4 bytes)
+ * @param magnitudes Saída com fft_size / 2 magnitudes
+ */
+void spectrum_compute(int16_t *frame, uint16_t *magnitudes);
+
+/**
+ * @brief Magnitudes do último espectro
+ *
+ * @return const uint16_t* Vetor com spectrum_get_bin_count() valores
+ */
+const uint16_t *spectrum_get_magnitudes(void);
+
+/**
+ * @brief Número de raias do espectro (metade do tamanho da FFT)
+ *
+ * @return uint16_t Número de raias
+ */
+uint16_t spectrum_get_bin_count(void);
+
+/**
+ * @brief Frequência central de uma raia
+ *
+ * @param bin Índice da raia
+ * @return uint32_t Frequência em Hz
+ */
+uint32_t spectrum_bin_frequency(uint16_t bin);
+
+/**
+ * @brief Lê as estatísticas de processamento
+ *
+ * @param stats Estrutura de saída
+ */
+void spectrum_get_stats(SpectrumStats *stats);
+
+#endif // SPECTRUM_ANALYZER_H
@@ -0,0 +1,52 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Fila sem travas de um produtor e um consumidor
+ *
+ * Pensada para a troca de dados entre os dois núcleos do RP2040:
+ * head só é escrito pelo produtor e tail só pelo consumidor, então
+ * nenhuma das pontas precisa de spinlock. Os elementos são copiados
+ * por valor para um buffer fornecido pelo usuário.
+ */
+typedef struct
+{
+    uint8_t *buffer;        ///< Área de armazenamento (capacity * element_size bytes)
+    uint16_t element_size;  ///< Tamanho de cada elemento em bytes
+    uint16_t capacity;      ///< Número de posições (potência de 2)
+    volatile uint32_t head; ///< Total de elementos inseridos (produtor)
+    volatile uint32_t tail; ///< Total de elementos retirados (consumidor)
+    volatile uint32_t dropped; ///< Inserções recusadas por fila cheia (produtor)
+} SpscQueue;
+
+/**
+ * @brief Inicializa a fila
+ *
+ * @param queue Fila a inicializar
+ * @param buffer Área de armazenamento com capacity * element_size bytes
+ * @param element_size Tamanho de cada elemento em bytes
+ * @param capacity Número de posições (potência de 2)
+ */
+void spsc_queue_init(SpscQueue *queue, void *buffer, uint16_t element_size, uint16_t capacity);
+
+/**
+ * @brief Insere um elemento (somente o produtor)
+ *
+ * @param queue Fila
+ * @param element Elemento a copiar para a fila
+ * @return bool Falso se a fila estava cheia (o elemento é descartado e contado)
+ */
+bool spsc_queue_push(SpscQueue *queue, const void *element);
+
+/**
+ * @brief Retira o elemento mais antigo (somente o consumidor)
+ *
+ * @param queue Fila
+ * @param element Destino da cópia
+ * @return bool Falso se a fila estava vazia
+ */
+bool spsc_queue_pop(SpscQueue *queue, void *element);
+
+#endif // SPSC_QUEUE_H
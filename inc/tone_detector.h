@@ -0,0 +1,112 @@
+#ifndef TONE_DETECTOR_H
+#define TONE_DETECTOR_H
+#include <stdbool.h>
+#include <stdint.h>
+#include "fixed_point.h"
+#include "drivers/mic/mic.h"
+
+/**
+ * @brief Maior número de detectores do banco
+ * Cada detector custa uma multiplicação por amostra; 16 detectores
+ * usam uma fração pequena dos ciclos de um bloco
+ */
+#define TONE_DETECTOR_MAX 16
+
+/**
+ * @brief Capacidade da fila de eventos entre os núcleos
+ */
+#define TONE_EVENT_QUEUE_SIZE 16
+
+/**
+ * @brief Potência AC mínima do bloco para considerar um tom (códigos^2)
+ * Abaixo disso o bloco é tratado como silêncio, sem tom
+ */
+#define TONE_MIN_BLOCK_POWER 16
+
+/**
+ * @brief Configuração de um detector
+ *
+ * A fração do tom é a parte da potência AC do bloco que está na
+ * frequência do detector: 1 para um tom puro, perto de 0 para ruído.
+ * O tom é confirmado depois de min_duration_ms acima de on_share e
+ * termina quando a fração cai abaixo de off_share.
+ *
+ * A resolução é a de um bloco: MIC_SAMPLE_RATE_HZ / SAMPLES (240 Hz a
+ * 48 kHz). Tons mais graves que isso não são separados do DC.
+ */
+typedef struct
+{
+    const char *name;         ///< Nome mostrado nos eventos
+    uint32_t frequency_hz;    ///< Frequência do tom
+    fx_q16_t on_share;        ///< Fração para ligar (Q15.16, 0..1)
+    fx_q16_t off_share;       ///< Fração para desligar (Q15.16, menor que on_share)
+    uint16_t min_duration_ms; ///< Tempo mínimo acima de on_share para confirmar o tom
+} ToneDetectorConfig;
+
+/**
+ * @brief Início ou fim de um tom
+ */
+typedef struct
+{
+    uint8_t detector;     ///< Índice do detector na configuração
+    bool active;          ///< true no início do tom, false no fim
+    uint32_t duration_ms; ///< Tempo do tom até o evento (no fim, a duração total)
+    fx_q16_t share;       ///< Fração do tom no bloco que gerou o evento
+} ToneEvent;
+
+/**
+ * @brief Monta o banco de detectores
+ *
+ * Os coeficientes dependem da taxa do ADC e são calculados uma vez,
+ * em float. A tabela de configuração precisa continuar válida.
+ *
+ * @param configs Configuração de cada detector
+ * @param count Número de detectores (até TONE_DETECTOR_MAX)
+ */
+void tone_detector_init(const ToneDetectorConfig *configs, uint8_t count);
+
+/**
+ * @brief Zera os detectores e a fila de eventos, mantendo a configuração
+ *
+ * Equivale a chamar tone_detector_init() de novo com a mesma tabela.
+ * Como a fila também é reiniciada, só pode ser chamada antes de o
+ * núcleo de interface começar a ler os eventos.
+ */
+void tone_detector_reset(void);
+
+/**
+ * @brief Passa um bloco da captura por todos os detectores
+ *
+ * Roda no núcleo de DSP. Cada detector é um Goertzel em ponto fixo
+ * sobre o bloco inteiro; os eventos vão para a fila lida por
+ * tone_detector_pop_event().
+ *
+ * @param samples Amostras de 12 bits do ADC
+ * @param stats Estatísticas do mesmo bloco (DC, potência AC e número de amostras)
+ */
+void tone_detector_process(const uint16_t *samples, const MicBlockStats *stats);
+
+/**
+ * @brief Retira o evento mais antigo (núcleo de interface)
+ *
+ * @param event Destino do evento
+ * @return bool Falso se não há evento
+ */
+bool tone_detector_pop_event(ToneEvent *event);
+
+/**
+ * @brief Configuração de um detector
+ *
+ * @param detector Índice do detector
+ * @return const ToneDetectorConfig* Configuração, ou NULL se o índice é inválido
+ */
+const ToneDetectorConfig *tone_detector_config(uint8_t detector);
+
+/**
+ * @brief Eventos perdidos por fila cheia
+ *
+ * @return uint32_t Total desde tone_detector_init()
+ */
+uint32_t tone_detector_get_dropped(void);
+
+#endif // TONE_DETECTOR_H
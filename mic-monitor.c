@@ -1,19 +1,184 @@
 #include "mic-monitor.h"
 #include "inc/audio_analyzer.h"
+#include "inc/audio_history.h"
 #include "inc/display_manager.h"
 #include "inc/button_handler.h"
+#include "inc/dsp_core.h"
+#include "inc/level_stats.h"
+#include "inc/band_filter.h"
+#include "inc/tone_detector.h"
+#include "inc/event_loop.h"
+#include "inc/scheduler.h"
+#include "inc/probe.h"
 #include "drivers/display-lcd/ssd1306.h"
 #include "drivers/display-lcd/ssd1306_bitmaps.h"
 #include "drivers/mic/mic.h"
 #include "pico/time.h"
 
 // Estado global de visualização
-bool show_graph = false;
+DisplayMode display_mode = DISPLAY_MODE_GRAPH;
 
 // PIO e sm
 static PIO pio;
 static uint sm, offset;
 
+// Estado compartilhado pelas tarefas do núcleo 0 (nunca rodam ao mesmo tempo)
+static AudioAnalysisFx analysis = {0}; // Último resultado recebido
+static bool redraw = true;             // A tela mudou desde o último quadro
+static bool frame_pending = false;     // Quadro desenhado e ainda não enviado
+
+/**
+ * Desenha a tela do modo selecionado
+ *
+ * @param analysis Último resultado da análise
+ */
+static void render_display(const AudioAnalysisFx *analysis)
+{
+    switch (display_mode)
+    {
+    case DISPLAY_MODE_GRAPH:
+        display_volume_graph();
+        break;
+    case DISPLAY_MODE_SPECTRUM:
+        display_spectrum();
+        break;
+    case DISPLAY_MODE_BANDS:
+        display_bands(&analysis->bands);
+        break;
+    default:
+        display_audio_monitor(audio_analysis_to_float(analysis));
+        break;
+    }
+}
+
+/**
+ * Imprime os contadores de perda dos dois núcleos e a atividade do laço principal
+ */
+static void report_counters(void)
+{
+    DspCoreCounters c;
+    dsp_core_get_counters(&c);
+    printf("blocos %lu perdidos %lu | fft perdidos %lu | resultados %lu/%lu fila cheia %lu agrupados %lu\n",
+           (unsigned long)c.blocks_captured, (unsigned long)c.blocks_dropped,
+           (unsigned long)c.spectrum_dropped,
+           (unsigned long)c.results_received, (unsigned long)c.results_published,
+           (unsigned long)c.results_dropped, (unsigned long)c.results_coalesced);
+
+    EventLoopStats loop;
+    event_loop_get_stats(&loop);
+    uint32_t elapsed_ms = loop.elapsed_us / 1000u;
+    if (elapsed_ms > 0)
+    {
+        printf("laco: %lu despertares/s, %lu eventos/s, ocioso %lu%%\n",
+               (unsigned long)(loop.wakeups * 1000u / elapsed_ms),
+               (unsigned long)(loop.events * 1000u / elapsed_ms),
+               (unsigned long)((uint64_t)loop.idle_us * 100u / loop.elapsed_us));
+    }
+}
+
+/**
+ * Imprime os tempos de cada tarefa do núcleo 0
+ */
+static void report_tasks(void)
+{
+    for (uint8_t t = 0; t < scheduler_get_task_count(); t++)
+    {
+        SchedulerTaskStats st;
+        scheduler_get_stats(t, &st);
+        printf("tarefa %-12s n %lu | min %lu med %lu max %lu us | espera max %lu us | prazos perdidos %lu\n",
+               scheduler_get_task(t)->name, (unsigned long)st.runs,
+               (unsigned long)st.min_us, (unsigned long)st.avg_us, (unsigned long)st.max_us,
+               (unsigned long)st.max_latency_us, (unsigned long)st.deadline_misses);
+    }
+}
+
+/**
+ * Imprime os registros das janelas de Leq/Ln que fecharam
+ */
+static void report_level_stats(void)
+{
+    static const char *names[LEVEL_STATS_WINDOW_COUNT] = {"1min", "15min", "1h"};
+    LevelStatsRecord r;
+    while (level_stats_pop_record(&r))
+    {
+        printf("LAeq %s #%lu: Leq %.1f Lmax %.1f Lmin %.1f L10 %.1f L50 %.1f L90 %.1f dB(A) (%lu periodos)\n",
+               names[r.window], (unsigned long)r.sequence,
+               FX_TO_FLOAT(r.leq), FX_TO_FLOAT(r.lmax), FX_TO_FLOAT(r.lmin),
+               FX_TO_FLOAT(r.l10), FX_TO_FLOAT(r.l50), FX_TO_FLOAT(r.l90),
+               (unsigned long)r.samples);
+
+        printf("bandas %s #%lu:", names[r.window], (unsigned long)r.sequence);
+        for (int b = 0; b < r.band_count; b++)
+        {
+            printf(" %lu:%.1f", (unsigned long)band_filter_center_hz(b), FX_TO_FLOAT(r.band_leq[b]));
+        }
+        printf(" dB\n");
+    }
+}
+
+/**
+ * Imprime os tons detectados e mostra no monitor o tom em andamento
+ *
+ * @return true se o tom mostrado mudou
+ */
+static bool report_tones(void)
+{
+    static uint32_t shown_hz = 0;
+    bool changed = false;
+    ToneEvent e;
+    while (tone_detector_pop_event(&e))
+    {
+        const ToneDetectorConfig *config = tone_detector_config(e.detector);
+        printf("tom %s (%lu Hz) %s: %lu ms, %lu%% da potencia\n",
+               config->name, (unsigned long)config->frequency_hz, e.active ? "inicio" : "fim",
+               (unsigned long)e.duration_ms, (unsigned long)((e.share * 100) >> 16));
+        // O fim de um tom só apaga o aviso se ele for o tom mostrado
+        if (e.active || config->frequency_hz == shown_hz)
+        {
+            shown_hz = e.active ? config->frequency_hz : 0;
+            display_set_tone(shown_hz);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+/**
+ * Aplica um gesto de botão à visualização
+ *
+ * A, toque curto: próxima tela; toque duplo: tela anterior;
+ * toque longo: gráfico, ou a próxima resolução dele se já estiver nele.
+ * B, toque curto: alterna a ponderação no tempo do monitor (F, S, I).
+ *
+ * @param event Evento retirado da fila dos botões
+ */
+static void handle_button(const ButtonEvent *event)
+{
+    if (event->button == BUTTON_A)
+    {
+        switch (event->gesture)
+        {
+        case BUTTON_GESTURE_SHORT:
+            display_mode = (display_mode + 1) % DISPLAY_MODE_COUNT;
+            break;
+        case BUTTON_GESTURE_DOUBLE:
+            display_mode = (display_mode + DISPLAY_MODE_COUNT - 1) % DISPLAY_MODE_COUNT;
+            break;
+        case BUTTON_GESTURE_LONG:
+            if (display_mode == DISPLAY_MODE_GRAPH)
+            {
+                display_graph_next_scale();
+            }
+            display_mode = DISPLAY_MODE_GRAPH;
+            break;
+        }
+    }
+    else if (event->button == BUTTON_B && event->gesture == BUTTON_GESTURE_SHORT)
+    {
+        display_set_time_weighting((display_get_time_weighting() + 1) % SOUND_TIME_COUNT);
+    }
+}
+
 /**
  * Inicializa o hardware e as bibliotecas
  */
@@ -22,74 +187,174 @@ void init_hardware(void)
     // Inicializa o stdio
     stdio_init_all();
 
-    // Inicializa o botão
-    init_button(BUTTON_A_PIN);
+    // Contador de ciclos das sondas do núcleo 0 (o núcleo 1 liga o dele)
+    probe_init();
 
-    // Inicializa o microfone
-    mic_init();
+    // Inicializa os botões (interrupção de borda, gestos reconhecidos fora do laço)
+    init_button(BUTTON_A, BUTTON_A_PIN);
+    init_button(BUTTON_B, BUTTON_B_PIN);
 
     // Inicializa o display SSD1306
     ssd1306_Init();
+
+#ifdef MIC_MONITOR_BENCHMARK
+    // Compara as primitivas pixel a pixel com os caminhos por bytes
+    display_benchmark(100);
+#endif
+
     ssd1306_Fill(Black);
 
     // Exibe mensagem de inicialização
     ssd1306_DrawBitmap(0, 0, virtuscc_bitmap, SSD1306_WIDTH, SSD1306_HEIGHT, White);
     ssd1306_UpdateScreen();
     sleep_ms(1500);
+
+    // Janelas de Leq/Ln alimentadas pelo núcleo 0
+    level_stats_init();
+
+    // Núcleo 1 assume o microfone, a captura contínua e a análise
+    dsp_core_start();
 }
 
 /**
- * Função principal que executa em loop
+ * Tarefa: aplica os gestos dos botões
  */
-int main(void)
+static void task_buttons(void)
 {
-    // Inicializa o hardware
-    init_hardware();
+    ButtonEvent button_event;
+    while (button_get_event(&button_event))
+    {
+        handle_button(&button_event);
+        redraw = true;
+    }
+}
 
-    // Variável para controle do tempo de atualização
-    uint32_t last_update_time = 0;
+/**
+ * Tarefa: recebe os resultados do núcleo 1
+ * Todos os resultados entram no histórico; só o mais recente é desenhado
+ */
+static void task_results(void)
+{
+    uint32_t received = 0;
+    while (dsp_core_receive(&analysis))
+    {
+        audio_history_push(&analysis);
+        level_stats_push(analysis.levels.db[SOUND_WEIGHTING_A][SOUND_TIME_FAST],
+                         analysis.levels.leq_db[SOUND_WEIGHTING_A], &analysis.bands);
+        received++;
+    }
+    if (received)
+    {
+        dsp_core_note_coalesced(received - 1);
+        redraw = true;
+    }
+}
 
-    // Preenche o buffer de histórico inicialmente com alguns valores
-    init_audio_history();
+/**
+ * Tarefa: tons detectados e janelas de Leq/Ln fechadas
+ */
+static void task_statistics(void)
+{
+    // Tons detectados saem na USB e no status do monitor
+    if (report_tones())
+    {
+        redraw = true;
+    }
 
-    // Inicializa gráfico como visualização padrão
-    show_graph = true;
+    // Janelas fechadas saem assim que ficam prontas
+    report_level_stats();
+}
+
+/**
+ * Tarefa: desenha a tela no framebuffer, só se algo mudou
+ */
+static void task_render(void)
+{
+    if (redraw)
+    {
+        render_display(&analysis);
+        redraw = false;
+        frame_pending = true;
+    }
+}
 
-    while (1)
+/**
+ * Tarefa: envia ao display o quadro desenhado
+ */
+static void task_flush(void)
+{
+    if (frame_pending)
     {
-        uint32_t current_time = to_ms_since_boot(get_absolute_time());
+        display_flush();
+        frame_pending = false;
+    }
+}
 
-        // Verifica se o botão foi pressionado
-        if (check_button())
+/**
+ * Tarefa: contadores de perda, atividade do laço e tempos das tarefas
+ */
+static void task_telemetry(void)
+{
+    report_counters();
+    report_tasks();
+}
+
+/**
+ * Tarefa: comandos de uma letra recebidos pela USB
+ * p imprime os histogramas das sondas, z zera os histogramas
+ */
+static void task_commands(void)
+{
+    int c;
+    while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT)
+    {
+        switch (c)
         {
-            // Alterna entre os modos de visualização
-            show_graph = !show_graph;
-            // Atualiza imediatamente o display após a troca
-            last_update_time = 0;
+        case 'p':
+            probe_dump();
+            break;
+        case 'z':
+            probe_reset();
+            printf("sondas zeradas\n");
+            break;
+        case '\r':
+        case '\n':
+            break;
+        default:
+            printf("comandos: p = histogramas das sondas, z = zerar\n");
+            break;
         }
+    }
+}
 
-        // Verifica se é hora de atualizar o display
-        if (current_time - last_update_time >= DISPLAY_UPDATE_MS)
-        {
-            // Analisa o áudio
-            AudioAnalysis analysis = analyze_audio();
+// Tarefas do núcleo 0; a captura e a análise rodam no núcleo 1, no ritmo do DMA
+static const SchedulerTask tasks[] = {
+    // nome, corpo, período, prazo, prioridade, eventos
+    {"botoes", task_buttons, 0, 20, 0, EVENT_LOOP_MASK(EVENT_LOOP_BUTTON)},
+    {"resultados", task_results, 0, DISPLAY_UPDATE_MS, 1, EVENT_LOOP_MASK(EVENT_LOOP_DSP_RESULT)},
+    {"render", task_render, DISPLAY_UPDATE_MS, DISPLAY_UPDATE_MS, 2, 0},
+    {"envio", task_flush, DISPLAY_UPDATE_MS, DISPLAY_UPDATE_MS, 3, 0},
+    {"estatisticas", task_statistics, 0, 500, 4, EVENT_LOOP_MASK(EVENT_LOOP_DSP_RESULT)},
+    {"telemetria", task_telemetry, COUNTERS_REPORT_MS, 1000, 5, 0},
+    {"comandos", task_commands, COMMAND_POLL_MS, 1000, 6, 0},
+};
 
-            // Exibe resultados no display conforme o modo selecionado
-            if (show_graph)
-            {
-                display_volume_graph();
-            }
-            else
-            {
-                display_audio_monitor(analysis);
-            }
+/**
+ * Função principal
+ * O núcleo 0 só executa as tarefas da tabela: desenha os resultados
+ * publicados pelo núcleo 1 e trata os botões
+ */
+int main(void)
+{
+    // Inicializa o hardware (e o núcleo 1, que inicia o histórico)
+    init_hardware();
 
-            last_update_time = current_time;
-        }
+    // Inicializa gráfico como visualização padrão
+    display_mode = DISPLAY_MODE_GRAPH;
 
-        // Pequena pausa para reduzir uso da CPU
-        sleep_ms(5); // Reduzido para maior taxa de amostragem
-    }
+    // Quadros em ritmo fixo, independentes da chegada dos resultados
+    scheduler_init(tasks, sizeof(tasks) / sizeof(tasks[0]));
+    scheduler_run();
 
     return 0;
-}
\ No newline at end of file
+}
@@ -11,12 +11,30 @@
  */
 #define BUTTON_A_PIN 5
 
+/** 
+ * @brief Pino GPIO do segundo botão
+ * Define o número do pino GPIO usado para o botão B 
+ */
+#define BUTTON_B_PIN 6
+
 /** 
  * @brief Intervalo de atualização do display
  * Tempo em milissegundos entre cada atualização da tela 
  */
 #define DISPLAY_UPDATE_MS 50
 
+/** 
+ * @brief Intervalo do relatório de contadores
+ * Tempo em milissegundos entre impressões dos contadores de perda no stdio 
+ */
+#define COUNTERS_REPORT_MS 5000
+
+/** 
+ * @brief Intervalo de leitura dos comandos
+ * Tempo em milissegundos entre leituras dos comandos recebidos pela USB 
+ */
+#define COMMAND_POLL_MS 100
+
 /**
  * @brief Inicializa o hardware do sistema
  * 
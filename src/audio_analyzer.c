@@ -1,53 +1,207 @@
 #include "inc/audio_analyzer.h"
+#include "inc/audio_history.h"
+#include "inc/noise_floor.h"
+#include "inc/tone_detector.h"
 #include "drivers/mic/mic.h"
+#include "inc/cycle_counter.h"
+#include "inc/probe.h"
 #include <math.h>
+#include <stdio.h>
 
-// Histórico para o gráfico de volume
-float voltage_history[HISTORY_SIZE] = {0};
-float noise_floor_history[HISTORY_SIZE] = {0}; // Histórico de ruído de fundo
-int history_index = 0;
+// Estimador do ruído de fundo (estatística de mínimos)
+static NoiseFloorTracker noise_tracker;
 
-// Sistema de cálculo de ruído de fundo
-#define NOISE_FLOOR_ALPHA 0.1f // Fator de suavização para cálculo do ruído de fundo
-float current_noise_floor = 0.0f;
+// Fator de suavização do ruído de fundo no caminho de referência em float
+#define NOISE_FLOOR_ALPHA 0.1f
+
+// Constantes da análise em Q15.16 (resolvidas em tempo de compilação)
+#define FX_GAIN FX_FROM_FLOAT(MIC_GAIN_FACTOR)
+#define FX_DB_OFFSET FX_FROM_FLOAT(100.0)
+#define FX_DB_MIN FX_FROM_FLOAT(25.0)
+
+// Blocos por período de análise (12 blocos de 200 amostras a 48 kHz = 50 ms)
+#define ANALYSIS_BLOCKS ((uint32_t)(MIC_SAMPLE_RATE_HZ * ANALYSIS_PERIOD_MS / 1000) / SAMPLES)
 
 /**
- * Inicializa o histórico de áudio com valores básicos
+ * Converte o RMS AC de um bloco em tensão (Q15.16, sem ganho)
+ *
+ * O RMS é calculado em Q4 (códigos * 16) e multiplicado por
+ * 3,3 V / 4096 códigos * 65536 / 16 = 3,3 ~= 3379 / 1024.
+ *
+ * @param stats Estatísticas do bloco
+ * @return Tensão RMS em Q15.16
+ */
+static fx_q16_t block_voltage_fx(const MicBlockStats *stats)
+{
+    uint32_t rms_q4 = fx_isqrt(stats->ac_power << 8);
+    return (fx_q16_t)((rms_q4 * 3379u) >> 10);
+}
+
+/**
+ * Inicializa o histórico de áudio vazio
+ *
+ * Os níveis começam sem entradas (audio_history_filled() trata a janela
+ * parcial) e o ruído de fundo parte do primeiro período analisado: só
+ * períodos completos entram em cada um, sem entradas com outra duração.
  */
 void init_audio_history(void)
 {
-    for (int i = 0; i < HISTORY_SIZE; i++)
-    {
-        mic_sample();
-        float voltage = mic_get_voltage() * MIC_GAIN_FACTOR; // Aplicando o mesmo ganho de sensibilidade
-        voltage_history[i] = voltage > 3.3f ? 3.3f : voltage;
-        noise_floor_history[i] = voltage * 0.3f; // Estimativa inicial de ruído
-    }
+    audio_history_init();
+    noise_floor_init(&noise_tracker, ANALYSIS_PERIOD_MS, ANALYSIS_BLOCKS * SAMPLES);
+}
+
+/**
+ * Calcula o ruído de fundo pelo mínimo da potência suavizada
+ *
+ * @param current_voltage Tensão atual lida do microfone (Q15.16)
+ * @return Valor estimado do ruído de fundo (Q15.16)
+ */
+fx_q16_t calculate_noise_floor_fx(fx_q16_t current_voltage)
+{
+    return noise_floor_update(&noise_tracker, current_voltage);
 }
 
 /**
- * Calcula o ruído de fundo usando um filtro de média móvel exponencial
+ * Versão em float de calculate_noise_floor_fx(), mantida por compatibilidade
  *
  * @param current_voltage Tensão atual lida do microfone
  * @return Valor estimado do ruído de fundo
  */
 float calculate_noise_floor(float current_voltage)
 {
-    // Se o ruído de fundo ainda não foi inicializado
-    if (current_noise_floor < 0.001f)
+    return FX_TO_FLOAT(calculate_noise_floor_fx((fx_q16_t)(current_voltage * FX_ONE)));
+}
+
+/**
+ * Analisa as estatísticas de um bloco em ponto fixo
+ *
+ * @param stats Estatísticas do bloco capturado
+ * @return Resultado da análise em Q15.16
+ */
+static AudioAnalysisFx analyze_block_fx(const MicBlockStats *stats)
+{
+    AudioAnalysisFx analysis = {0};
+
+    // RMS total (com DC) em códigos e RMS AC em volts
+    uint32_t dc = stats->dc_mean;
+    uint32_t rms_codes = fx_isqrt(dc * dc + stats->ac_power);
+    analysis.voltage = block_voltage_fx(stats);
+
+    // Aplica um ganho para AUMENTAR DRASTICAMENTE a sensibilidade
+    analysis.voltage = fx_mul(analysis.voltage, FX_GAIN);
+    analysis.rms_value = fx_mul(FX_FROM_INT(rms_codes), FX_GAIN);
+
+    // Calcula o ruído de fundo
+    analysis.noise_floor = calculate_noise_floor_fx(analysis.voltage);
+
+    // Verifica se o volume está baixo. O limiar vale para o próprio nível: o
+    // ruído de fundo converge para qualquer som estável, e somado ao limiar
+    // marcaria como baixo todo som contínuo
+    analysis.is_low_volume = (analysis.voltage < FX_FROM_FLOAT(VOLUME_THRESHOLD_LOW));
+
+    // Verifica se está ocorrendo clipping
+    analysis.is_clipping = (analysis.voltage > FX_FROM_FLOAT(VOLUME_THRESHOLD_HIGH));
+
+    // Estima o valor em dB: 20 * log10(voltage) + 100, com mínimo de 25 dB
+    analysis.estimated_db = FX_DB_MIN;
+    if (analysis.voltage > 0)
     {
-        current_noise_floor = current_voltage * 0.5f; // Inicializa com metade do valor atual
+        fx_q16_t db = fx_amplitude_to_db(analysis.voltage) + FX_DB_OFFSET;
+        if (db > FX_DB_MIN)
+        {
+            analysis.estimated_db = db;
+        }
     }
 
-    // Se o valor atual está abaixo do ruído atual + margem, considera parte do ruído
-    if (current_voltage < (current_noise_floor * 1.5f))
+    return analysis;
+}
+
+/**
+ * Analisa os dados de áudio do microfone em ponto fixo
+ *
+ * @return Estrutura AudioAnalysisFx com os resultados da análise
+ */
+AudioAnalysisFx analyze_audio_fx(void)
+{
+    // Coleta amostras do microfone (as estatísticas do bloco saem junto)
+    mic_sample();
+
+    AudioAnalysisFx analysis = analyze_block_fx(mic_get_stats());
+
+    // Ponderações A/C e bandas sobre as amostras do bloco
+    sound_level_process(mic_get_buffer(), SAMPLES);
+    sound_level_get(&analysis.levels);
+    band_filter_process(mic_get_buffer(), SAMPLES);
+    band_filter_get(&analysis.bands);
+
+    // Armazena no histórico para o gráfico
+    audio_history_push(&analysis);
+
+    return analysis;
+}
+
+// Acumuladores do período de análise em andamento
+static uint32_t period_blocks = 0;
+static uint32_t period_dc_sum = 0;
+static uint32_t period_power_sum = 0;
+
+/**
+ * Acumula um bloco e analisa o período quando ele completa
+ *
+ * @param stats Estatísticas do bloco
+ * @param result Saída com a análise do período
+ * @return true se um período foi completado
+ */
+bool audio_analyzer_push_block(const MicBlockStats *stats, AudioAnalysisFx *result)
+{
+    period_dc_sum += stats->dc_mean;
+    period_power_sum += stats->ac_power;
+    period_blocks++;
+
+    if (period_blocks < ANALYSIS_BLOCKS)
     {
-        // Atualiza o ruído de fundo com um filtro EMA (Exponential Moving Average)
-        current_noise_floor = (NOISE_FLOOR_ALPHA * current_voltage) +
-                              ((1.0f - NOISE_FLOOR_ALPHA) * current_noise_floor);
+        return false;
     }
 
-    return current_noise_floor;
+    // Potência média de todas as amostras do período
+    MicBlockStats period = {
+        .dc_mean = period_dc_sum / period_blocks,
+        .ac_power = period_power_sum / period_blocks,
+    };
+    PROBE_BEGIN(PROBE_ANALYZE_AUDIO);
+    *result = analyze_block_fx(&period);
+    PROBE_END(PROBE_ANALYZE_AUDIO);
+
+    period_blocks = 0;
+    period_dc_sum = 0;
+    period_power_sum = 0;
+    return true;
+}
+
+/**
+ * Converte o resultado em ponto fixo para a visão em float usada pelo display
+ *
+ * @param analysis Resultado em Q15.16
+ * @return Mesmo resultado em float
+ */
+AudioAnalysis audio_analysis_to_float(const AudioAnalysisFx *analysis)
+{
+    AudioAnalysis result = {
+        .voltage = FX_TO_FLOAT(analysis->voltage),
+        .rms_value = FX_TO_FLOAT(analysis->rms_value),
+        .estimated_db = FX_TO_FLOAT(analysis->estimated_db),
+        .is_clipping = analysis->is_clipping,
+        .is_low_volume = analysis->is_low_volume,
+        .noise_floor = FX_TO_FLOAT(analysis->noise_floor),
+    };
+    for (int w = 0; w < SOUND_WEIGHTING_COUNT; w++)
+    {
+        for (int t = 0; t < SOUND_TIME_COUNT; t++)
+        {
+            result.weighted_db[w][t] = FX_TO_FLOAT(analysis->levels.db[w][t]);
+        }
+    }
+    return result;
 }
 
 /**
@@ -57,50 +211,143 @@ float calculate_noise_floor(float current_voltage)
  */
 AudioAnalysis analyze_audio(void)
 {
-    AudioAnalysis analysis = {0};
-
-    // Coleta amostras do microfone
-    mic_sample();
-
-    // Obtém valores da biblioteca do microfone
-    analysis.rms_value = mic_get_rms();
-    analysis.voltage = mic_get_voltage();
+    PROBE_BEGIN(PROBE_ANALYZE_AUDIO);
+    AudioAnalysisFx analysis = analyze_audio_fx();
+    PROBE_END(PROBE_ANALYZE_AUDIO);
+    return audio_analysis_to_float(&analysis);
+}
 
-    // Aplica um ganho para AUMENTAR DRASTICAMENTE a sensibilidade
-    analysis.voltage *= MIC_GAIN_FACTOR;
-    analysis.rms_value *= MIC_GAIN_FACTOR;
+// ==================== Comparação float x ponto fixo ====================
 
-    // Calcula o ruído de fundo
-    analysis.noise_floor = calculate_noise_floor(analysis.voltage * 0.3f);
+/**
+ * Caminho de análise em float (implementação anterior), usado como referência
+ *
+ * @param stats Estatísticas do bloco
+ * @param noise_floor Estado do ruído de fundo em float
+ * @return Resultado da análise em float
+ */
+static AudioAnalysis analyze_block_float(const MicBlockStats *stats, float *noise_floor)
+{
+    AudioAnalysis analysis = {0};
 
-    // Armazena no histórico para o gráfico (com limitação para evitar valores extremos)
-    voltage_history[history_index] = analysis.voltage > 3.3f ? 3.3f : analysis.voltage;
-    noise_floor_history[history_index] = analysis.noise_floor;
-    history_index = (history_index + 1) % HISTORY_SIZE;
+    float dc = stats->dc_mean;
+    analysis.rms_value = sqrtf(dc * dc + (float)stats->ac_power) * MIC_GAIN_FACTOR;
+    analysis.voltage = sqrtf((float)stats->ac_power) * 3.3f / (1 << 12u) * MIC_GAIN_FACTOR;
 
-    // Verifica se o volume está baixo (em relação ao ruído de fundo)
-    analysis.is_low_volume = (analysis.voltage < (analysis.noise_floor + VOLUME_THRESHOLD_LOW));
+    float input = analysis.voltage * 0.3f;
+    if (*noise_floor < 0.001f)
+    {
+        *noise_floor = input * 0.5f;
+    }
+    if (input < (*noise_floor * 1.5f))
+    {
+        *noise_floor = (NOISE_FLOOR_ALPHA * input) + ((1.0f - NOISE_FLOOR_ALPHA) * *noise_floor);
+    }
+    analysis.noise_floor = *noise_floor;
 
-    // Verifica se está ocorrendo clipping
+    analysis.is_low_volume = (analysis.voltage < VOLUME_THRESHOLD_LOW);
     analysis.is_clipping = (analysis.voltage > VOLUME_THRESHOLD_HIGH);
 
-    // Estima o valor em dB (aproximação simplificada e muito mais sensível)
+    analysis.estimated_db = 25.0f;
     if (analysis.voltage > 0)
     {
-        // Conversão para dB - referência ajustada para faixas típicas de ambientes silenciosos
-        // dB = 20 * log10(voltage/reference) + offset
-        analysis.estimated_db = 20.0f * log10f(analysis.voltage) + 100.0f; // Offset aumentado para maior sensibilidade
-
-        // Garantir um valor mínimo razoável para o dB
+        analysis.estimated_db = 20.0f * log10f(analysis.voltage) + 100.0f;
         if (analysis.estimated_db < 25.0f)
         {
             analysis.estimated_db = 25.0f;
         }
     }
-    else
+
+    return analysis;
+}
+
+/**
+ * Processa o mesmo bloco pelos caminhos float e ponto fixo e imprime os ciclos gastos
+ *
+ * @param iterations Número de repetições de cada caminho
+ */
+void audio_analyzer_benchmark(uint32_t iterations)
+{
+    if (iterations == 0)
+    {
+        return;
+    }
+
+    cycle_counter_init();
+
+    // Um único bloco capturado alimenta os dois caminhos
+    mic_sample();
+    const uint16_t *block = mic_get_buffer();
+    const uint16_t reference = mic_get_stats()->dc_mean;
+
+    NoiseFloorTracker saved_tracker = noise_tracker;
+    float float_noise_floor = 0.0f;
+    uint32_t float_cycles = 0;
+    uint32_t fx_cycles = 0;
+    AudioAnalysis float_result = {0};
+    AudioAnalysisFx fx_result = {0};
+    MicBlockStats stats;
+
+    for (uint32_t i = 0; i < iterations; i++)
     {
-        analysis.estimated_db = 25.0f; // Valor mínimo de dB ajustado para maior sensibilidade
+        uint32_t start = cycle_counter_now();
+        mic_block_stats(block, SAMPLES, reference, &stats);
+        float_result = analyze_block_float(&stats, &float_noise_floor);
+        float_cycles += cycle_counter_elapsed(start);
+
+        start = cycle_counter_now();
+        mic_block_stats(block, SAMPLES, reference, &stats);
+        fx_result = analyze_block_fx(&stats);
+        fx_cycles += cycle_counter_elapsed(start);
     }
 
-    return analysis;
-}
\ No newline at end of file
+    noise_tracker = saved_tracker;
+
+    // Ponderações A/C amostra a amostra sobre o mesmo bloco
+    uint32_t weighting_cycles = 0;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        uint32_t start = cycle_counter_now();
+        sound_level_process(block, SAMPLES);
+        weighting_cycles += cycle_counter_elapsed(start);
+    }
+
+    // Os integradores e o Leq não podem começar com o bloco repetido
+    sound_level_init();
+
+    // Banco de filtros de oitava sobre o mesmo bloco
+    uint32_t band_cycles = 0;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        uint32_t start = cycle_counter_now();
+        band_filter_process(block, SAMPLES);
+        band_cycles += cycle_counter_elapsed(start);
+    }
+
+    // Idem para os filtros e as somas das bandas
+    band_filter_reset();
+
+    // Detectores de tom configurados, sobre o mesmo bloco
+    uint32_t tone_cycles = 0;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        uint32_t start = cycle_counter_now();
+        tone_detector_process(block, &stats);
+        tone_cycles += cycle_counter_elapsed(start);
+    }
+
+    // O mesmo bloco repetido deixaria tons "ativos" e eventos na fila;
+    // a captura começa com os detectores zerados
+    tone_detector_reset();
+
+    AudioAnalysis fx_view = audio_analysis_to_float(&fx_result);
+    printf("analise float: %lu ciclos/bloco (%.2f V, %.1f dB)\n",
+           (unsigned long)(float_cycles / iterations), float_result.voltage, float_result.estimated_db);
+    printf("analise fixa:  %lu ciclos/bloco (%.2f V, %.1f dB)\n",
+           (unsigned long)(fx_cycles / iterations), fx_view.voltage, fx_view.estimated_db);
+    printf("ponderacao A/C: %lu ciclos/bloco (%lu amostras)\n",
+           (unsigned long)(weighting_cycles / iterations), (unsigned long)SAMPLES);
+    printf("bandas (%u):    %lu ciclos/bloco\n",
+           (unsigned)band_filter_get_count(), (unsigned long)(band_cycles / iterations));
+    printf("tons:          %lu ciclos/bloco\n", (unsigned long)(tone_cycles / iterations));
+}
@@ -0,0 +1,151 @@
+#include "inc/audio_history.h"
+#include <string.h>
+
+// Entradas do nível anterior resumidas por uma entrada de cada nível
+static const uint8_t history_level_ratio[HISTORY_LEVEL_COUNT] = {
+    1,                          // Cada resultado da análise
+    1000 / ANALYSIS_PERIOD_MS,  // 1 s
+    60,                         // 1 min
+    60,                         // 1 h
+};
+
+/**
+ * Intervalo aberto de um nível: acumula as entradas do nível anterior
+ * até completar history_level_ratio
+ */
+typedef struct
+{
+    uint32_t voltage_sum;
+    uint32_t noise_sum;
+    history_code_t voltage_min;
+    history_code_t voltage_max;
+    history_code_t noise_min;
+    history_code_t noise_max;
+    uint8_t entries;
+} HistoryBucket;
+
+static HistoryLevel history_levels[HISTORY_LEVEL_COUNT];
+static HistoryBucket history_buckets[HISTORY_LEVEL_COUNT];
+
+// Limite da tensão armazenada, o mesmo do gráfico
+#define FX_MAX_VOLTAGE FX_FROM_FLOAT(3.3)
+
+/**
+ * Converte um valor Q15.16 em código do histórico
+ *
+ * @param value Tensão em Q15.16
+ * @return Código limitado a 0..HISTORY_CODE_MAX
+ */
+static history_code_t history_code(fx_q16_t value)
+{
+    if (value <= 0)
+        return 0;
+    value >>= HISTORY_CODE_SHIFT;
+    return value > HISTORY_CODE_MAX ? HISTORY_CODE_MAX : (history_code_t)value;
+}
+
+/**
+ * Limpa todos os níveis do histórico
+ */
+void audio_history_init(void)
+{
+    memset(history_levels, 0, sizeof(history_levels));
+    memset(history_buckets, 0, sizeof(history_buckets));
+}
+
+/**
+ * Fecha uma entrada de um nível e a acumula no intervalo do nível seguinte
+ *
+ * @param level Nível da entrada
+ * @param entry Envelope da entrada
+ */
+static void history_store(int level, const HistoryBucket *entry)
+{
+    HistoryLevel *history = &history_levels[level];
+    uint8_t slot = history->index;
+    uint32_t half = entry->entries / 2;
+
+    history->voltage_min[slot] = entry->voltage_min;
+    history->voltage_max[slot] = entry->voltage_max;
+    history->voltage_mean[slot] = (history_code_t)((entry->voltage_sum + half) / entry->entries);
+    history->noise_min[slot] = entry->noise_min;
+    history->noise_max[slot] = entry->noise_max;
+    history->noise_mean[slot] = (history_code_t)((entry->noise_sum + half) / entry->entries);
+    history->index = (slot + 1) % HISTORY_SIZE;
+    history->count++;
+
+    if (level + 1 >= HISTORY_LEVEL_COUNT)
+    {
+        return;
+    }
+
+    // As médias do próximo nível são médias de médias: todos os intervalos têm o mesmo peso
+    HistoryBucket *bucket = &history_buckets[level + 1];
+    if (bucket->entries == 0)
+    {
+        bucket->voltage_min = entry->voltage_min;
+        bucket->voltage_max = entry->voltage_max;
+        bucket->noise_min = entry->noise_min;
+        bucket->noise_max = entry->noise_max;
+    }
+    else
+    {
+        if (entry->voltage_min < bucket->voltage_min) bucket->voltage_min = entry->voltage_min;
+        if (entry->voltage_max > bucket->voltage_max) bucket->voltage_max = entry->voltage_max;
+        if (entry->noise_min < bucket->noise_min) bucket->noise_min = entry->noise_min;
+        if (entry->noise_max > bucket->noise_max) bucket->noise_max = entry->noise_max;
+    }
+    bucket->voltage_sum += history->voltage_mean[slot];
+    bucket->noise_sum += history->noise_mean[slot];
+    bucket->entries++;
+
+    if (bucket->entries == history_level_ratio[level + 1])
+    {
+        history_store(level + 1, bucket);
+        memset(bucket, 0, sizeof(*bucket));
+    }
+}
+
+/**
+ * Armazena um resultado no histórico do gráfico
+ *
+ * @param analysis Resultado da análise
+ */
+void audio_history_push(const AudioAnalysisFx *analysis)
+{
+    // Limitação para evitar valores extremos
+    history_code_t voltage = history_code(analysis->voltage > FX_MAX_VOLTAGE ? FX_MAX_VOLTAGE : analysis->voltage);
+    history_code_t noise = history_code(analysis->noise_floor);
+
+    HistoryBucket entry = {
+        .voltage_sum = voltage,
+        .noise_sum = noise,
+        .voltage_min = voltage,
+        .voltage_max = voltage,
+        .noise_min = noise,
+        .noise_max = noise,
+        .entries = 1,
+    };
+    history_store(HISTORY_LEVEL_BLOCK, &entry);
+}
+
+const HistoryLevel *audio_history_level(HistoryLevelId level)
+{
+    return &history_levels[level];
+}
+
+/**
+ * Duração de uma entrada de um nível
+ *
+ * @param level Nível
+ * @return Duração em milissegundos
+ */
+uint32_t audio_history_period_ms(HistoryLevelId level)
+{
+    uint32_t period = ANALYSIS_PERIOD_MS;
+    for (int i = 1; i <= (int)level; i++)
+    {
+        period *= history_level_ratio[i];
+    }
+    return period;
+}
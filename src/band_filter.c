@@ -0,0 +1,364 @@
+#include "inc/band_filter.h"
+#include "inc/audio_analyzer.h"
+#include "drivers/mic/mic.h"
+#include <math.h>
+#include <string.h>
+
+/*
+ * Banco de filtros multitaxa: o estágio 0 roda na taxa do ADC e cada
+ * estágio seguinte recebe a saída do anterior passada por um passa-baixas
+ * de Butterworth de 4ª ordem e decimada por 2. Cada banda é um passa-faixa
+ * de Butterworth de 4ª ordem (duas seções biquad), projetado na taxa do
+ * estágio mais lento em que a borda superior da banda fica abaixo de
+ * BAND_STAGE_EDGE da taxa. Assim os polos das bandas graves não ficam
+ * colados no círculo unitário e a precisão de 32 bits basta.
+ */
+#define BAND_PI 3.14159265f
+
+// Entrada em Q2 de códigos do ADC: +-8192
+#define BAND_INPUT_SHIFT 2
+#define BAND_ADC_MIDSCALE ((MIC_ADC_MAX + 1) / 2)
+
+// Coeficientes das seções em Q14
+#define BAND_COEF_SHIFT 14
+
+// Borda superior das bandas de um estágio decimado, em fração da taxa do estágio
+#define BAND_STAGE_EDGE 0.25f
+
+// Corte do anti-aliasing em fração da taxa: passa a borda do estágio seguinte
+// (0,125) com menos de 0,4 dB e atenua ~48 dB o que dobraria sobre ela
+#define BAND_DECIMATION_CUTOFF 0.18f
+
+// Potência média por amostra em Q16 de (códigos Q2)^2
+#define BAND_POWER_FRAC 16
+
+/**
+ * Seção biquad em forma direta I: y = b0*x + b1*x1 + b2*x2 + a1*y1 + a2*y2
+ * (a1 e a2 guardados com o sinal trocado). O resto do deslocamento volta
+ * na amostra seguinte, como nos passa-altas das ponderações
+ */
+typedef struct
+{
+    int32_t b0, b1, b2; ///< Numerador em Q14
+    int32_t a1, a2;     ///< Denominador em Q14, com o sinal trocado
+    int32_t x1, x2;     ///< Entradas anteriores
+    int32_t y1, y2;     ///< Saídas anteriores
+    int32_t err;        ///< Resto do último deslocamento
+} BandBiquad;
+
+/**
+ * Banda: passa-faixa de 4ª ordem e energia acumulada no período
+ */
+typedef struct
+{
+    BandBiquad section[2];
+    uint64_t energy; ///< Soma dos quadrados da saída
+} Band;
+
+/**
+ * Estágio: bandas na mesma taxa e anti-aliasing para o estágio seguinte
+ */
+typedef struct
+{
+    BandBiquad lowpass[2]; ///< Butterworth de 4ª ordem antes da decimação
+    uint8_t first_band;    ///< Primeira banda do estágio
+    uint8_t band_count;    ///< Bandas do estágio
+    uint8_t phase;         ///< Amostra descartada ou mantida na decimação
+    uint32_t samples;      ///< Amostras do período na taxa do estágio
+} BandStage;
+
+static Band bands[BAND_FILTER_MAX_BANDS];
+static uint32_t band_centers[BAND_FILTER_MAX_BANDS];
+static uint8_t band_count = 0;
+static BandStage stages[BAND_FILTER_MAX_STAGES];
+static uint8_t stage_count = 0;
+static BandFilterMode band_mode = BAND_FILTER_OCTAVE;
+
+// Conversão de 10*log10(potência) para a escala de estimated_db
+static fx_q16_t band_db_offset;
+
+// Bloco do estágio em andamento; a decimação reaproveita o mesmo buffer
+static int32_t stage_buffer[SAMPLES];
+
+// ==================== Projeto dos filtros (float, só na inicialização) ====================
+
+typedef struct
+{
+    float re;
+    float im;
+} BandComplex;
+
+static BandComplex complex_mul(BandComplex a, BandComplex b)
+{
+    return (BandComplex){a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re};
+}
+
+static BandComplex complex_div(BandComplex a, BandComplex b)
+{
+    float d = b.re * b.re + b.im * b.im;
+    return (BandComplex){(a.re * b.re + a.im * b.im) / d, (a.im * b.re - a.re * b.im) / d};
+}
+
+static BandComplex complex_sqrt(BandComplex a)
+{
+    float r = sqrtf(sqrtf(a.re * a.re + a.im * a.im));
+    float t = atan2f(a.im, a.re) / 2.0f;
+    return (BandComplex){r * cosf(t), r * sinf(t)};
+}
+
+static int32_t coefficient(float value)
+{
+    return (int32_t)lrintf(value * (1 << BAND_COEF_SHIFT));
+}
+
+/**
+ * Módulo de uma seção com numerador (b0, b1, b2) e denominador (1, a1, a2) em w
+ */
+static float section_gain(float b0, float b1, float b2, float a1, float a2, float w)
+{
+    BandComplex z1 = {cosf(w), -sinf(w)};
+    BandComplex z2 = complex_mul(z1, z1);
+    BandComplex num = {b0 + b1 * z1.re + b2 * z2.re, b1 * z1.im + b2 * z2.im};
+    BandComplex den = {1.0f + a1 * z1.re + a2 * z2.re, a1 * z1.im + a2 * z2.im};
+    return sqrtf((num.re * num.re + num.im * num.im) / (den.re * den.re + den.im * den.im));
+}
+
+static void biquad_set(BandBiquad *s, float b0, float b1, float b2, float a1, float a2)
+{
+    memset(s, 0, sizeof(*s));
+    s->b0 = coefficient(b0);
+    s->b1 = coefficient(b1);
+    s->b2 = coefficient(b2);
+    s->a1 = coefficient(-a1);
+    s->a2 = coefficient(-a2);
+}
+
+/**
+ * Passa-faixa de Butterworth de 4ª ordem entre low e high, na taxa rate
+ *
+ * O protótipo passa-baixas de 2ª ordem vira passa-faixa (cada polo p
+ * gera as raízes de s^2 - p*B*s + W0^2), e cada par conjugado vira uma
+ * seção pela bilinear com bordas pré-distorcidas. Os zeros ficam em
+ * z = 1 e z = -1, e cada seção tem ganho 1 na frequência central.
+ */
+static void band_pass_design(Band *band, float low, float high, float rate)
+{
+    float w1 = tanf(BAND_PI * low / rate);
+    float w2 = tanf(BAND_PI * high / rate);
+    float w0_sq = w1 * w2;
+    float center = 2.0f * atanf(sqrtf(w0_sq));
+
+    BandComplex pb = {-0.70710678f * (w2 - w1), 0.70710678f * (w2 - w1)};
+    BandComplex disc = complex_sqrt((BandComplex){complex_mul(pb, pb).re - 4.0f * w0_sq, complex_mul(pb, pb).im});
+    BandComplex poles[2] = {
+        {(pb.re + disc.re) / 2.0f, (pb.im + disc.im) / 2.0f},
+        {(pb.re - disc.re) / 2.0f, (pb.im - disc.im) / 2.0f},
+    };
+
+    for (int i = 0; i < 2; i++)
+    {
+        BandComplex z = complex_div((BandComplex){1.0f + poles[i].re, poles[i].im},
+                                    (BandComplex){1.0f - poles[i].re, -poles[i].im});
+        float a1 = -2.0f * z.re;
+        float a2 = z.re * z.re + z.im * z.im;
+        float g = 1.0f / section_gain(1.0f, 0.0f, -1.0f, a1, a2, center);
+        biquad_set(&band->section[i], g, 0.0f, -g, a1, a2);
+    }
+    band->energy = 0;
+}
+
+/**
+ * Passa-baixas de Butterworth de 4ª ordem em BAND_DECIMATION_CUTOFF da taxa
+ */
+static void low_pass_design(BandBiquad section[2])
+{
+    static const float q[2] = {0.54119610f, 1.3065630f};
+    float k = tanf(BAND_PI * BAND_DECIMATION_CUTOFF);
+    for (int i = 0; i < 2; i++)
+    {
+        float norm = 1.0f / (1.0f + k / q[i] + k * k);
+        float b0 = k * k * norm;
+        biquad_set(&section[i], b0, 2.0f * b0, b0, 2.0f * (k * k - 1.0f) * norm, (1.0f - k / q[i] + k * k) * norm);
+    }
+}
+
+/**
+ * Monta as bandas do modo, da mais grave (31,5 Hz) até a última abaixo de Nyquist
+ */
+void band_filter_init(BandFilterMode mode)
+{
+    const float rate = MIC_SAMPLE_RATE_HZ;
+    const int per_octave = (mode == BAND_FILTER_THIRD_OCTAVE) ? 3 : 1;
+    uint8_t band_stage[BAND_FILTER_MAX_BANDS];
+
+    memset(bands, 0, sizeof(bands));
+    memset(stages, 0, sizeof(stages));
+    band_mode = mode;
+    band_count = 0;
+    stage_count = 0;
+
+    // Centros em base 2 a partir de 1 kHz: 1000 * 2^(n / per_octave), começando em 31,25 Hz
+    for (int n = -5 * per_octave; band_count < BAND_FILTER_MAX_BANDS; n++)
+    {
+        float center = 1000.0f * exp2f((float)n / per_octave);
+        float half_width = exp2f(0.5f / per_octave);
+        float high = center * half_width;
+        if (high >= rate / 2.0f)
+        {
+            break;
+        }
+
+        // Estágio mais decimado em que a banda ainda fica abaixo da borda
+        int k = 0;
+        while (k + 1 < BAND_FILTER_MAX_STAGES && high <= BAND_STAGE_EDGE * rate / (float)(1u << (k + 1)))
+        {
+            k++;
+        }
+
+        band_pass_design(&bands[band_count], center / half_width, high, rate / (float)(1u << k));
+        band_centers[band_count] = (uint32_t)lrintf(center);
+        band_stage[band_count] = (uint8_t)k;
+        if (k + 1 > stage_count)
+        {
+            stage_count = (uint8_t)(k + 1);
+        }
+        band_count++;
+    }
+
+    // As bandas sobem em frequência, então as de cada estágio são contíguas
+    for (int b = band_count - 1; b >= 0; b--)
+    {
+        BandStage *stage = &stages[band_stage[b]];
+        stage->first_band = (uint8_t)b;
+        stage->band_count++;
+    }
+    for (int k = 0; k < stage_count; k++)
+    {
+        low_pass_design(stages[k].lowpass);
+    }
+
+    // 20*log10(V) + 100 com V = sqrt(potência) / 4 * 3,3 V / 4096 * ganho
+    float calibration = 20.0f * log10f(3.3f * MIC_GAIN_FACTOR / (4096.0f * (1 << BAND_INPUT_SHIFT))) + 100.0f;
+    band_db_offset = (fx_q16_t)lrintf(calibration * 65536.0f);
+}
+
+// ==================== Processamento (inteiros) ====================
+
+static inline int32_t biquad(BandBiquad *s, int32_t x)
+{
+    int32_t acc = s->b0 * x + s->b1 * s->x1 + s->b2 * s->x2 + s->a1 * s->y1 + s->a2 * s->y2 + s->err;
+    int32_t y = acc >> BAND_COEF_SHIFT;
+    s->err = acc & ((1 << BAND_COEF_SHIFT) - 1);
+    s->x2 = s->x1;
+    s->x1 = x;
+    s->y2 = s->y1;
+    s->y1 = y;
+    return y;
+}
+
+/**
+ * Filtra o bloco do estágio por uma banda e acumula os quadrados
+ */
+static void band_accumulate(Band *band, const int32_t *samples, uint32_t count)
+{
+    uint64_t energy = band->energy;
+    while (count--)
+    {
+        int32_t y = biquad(&band->section[1], biquad(&band->section[0], *samples++));
+        // |y| fica abaixo de 2^16, então o quadrado cabe em 32 bits sem sinal
+        uint32_t m = (uint32_t)(y < 0 ? -y : y);
+        energy += m * m;
+    }
+    band->energy = energy;
+}
+
+void band_filter_reset(void)
+{
+    band_filter_init(band_mode);
+}
+
+/**
+ * Filtra um bloco por todos os estágios, decimando entre eles
+ *
+ * @param samples Amostras de 12 bits do ADC
+ * @param count Número de amostras
+ */
+void band_filter_process(const uint16_t *samples, uint32_t count)
+{
+    while (count)
+    {
+        uint32_t n = count > SAMPLES ? SAMPLES : count;
+        count -= n;
+        for (uint32_t i = 0; i < n; i++)
+        {
+            stage_buffer[i] = ((int32_t)*samples++ - BAND_ADC_MIDSCALE) << BAND_INPUT_SHIFT;
+        }
+
+        for (int k = 0; k < stage_count && n > 0; k++)
+        {
+            BandStage *stage = &stages[k];
+            for (int b = stage->first_band; b < stage->first_band + stage->band_count; b++)
+            {
+                band_accumulate(&bands[b], stage_buffer, n);
+            }
+            stage->samples += n;
+
+            if (k + 1 == stage_count)
+            {
+                break;
+            }
+
+            // Anti-aliasing e decimação por 2 no próprio buffer; a fase segue entre blocos
+            uint32_t kept = 0;
+            for (uint32_t i = 0; i < n; i++)
+            {
+                int32_t y = biquad(&stage->lowpass[1], biquad(&stage->lowpass[0], stage_buffer[i]));
+                stage->phase ^= 1;
+                if (stage->phase == 0)
+                {
+                    stage_buffer[kept++] = y;
+                }
+            }
+            n = kept;
+        }
+    }
+}
+
+/**
+ * Converte a energia de cada banda em dB na escala de estimated_db e
+ * fecha o período
+ *
+ * @param levels Estrutura de saída
+ */
+void band_filter_get(BandLevels *levels)
+{
+    memset(levels, 0, sizeof(*levels));
+    levels->count = band_count;
+    levels->mode = (uint8_t)band_mode;
+
+    for (int k = 0; k < stage_count; k++)
+    {
+        BandStage *stage = &stages[k];
+        for (int b = stage->first_band; b < stage->first_band + stage->band_count; b++)
+        {
+            if (stage->samples > 0 && bands[b].energy > 0)
+            {
+                uint64_t mean = (bands[b].energy << BAND_POWER_FRAC) / stage->samples;
+                fx_q16_t db = fx_power_to_db(mean, BAND_POWER_FRAC) + band_db_offset;
+                levels->db[b] = db > 0 ? db : 0;
+            }
+            bands[b].energy = 0;
+        }
+        stage->samples = 0;
+    }
+}
+
+uint8_t band_filter_get_count(void)
+{
+    return band_count;
+}
+
+uint32_t band_filter_center_hz(uint8_t band)
+{
+    return band < band_count ? band_centers[band] : 0;
+}
@@ -1,62 +1,240 @@
 #include "inc/button_handler.h"
+#include "inc/spsc_queue.h"
+#include "inc/event_loop.h"
 #include "pico/stdlib.h"
 #include "pico/time.h"
+#include "hardware/gpio.h"
 
-// Variáveis para controle do botão
-static uint button_pin;
-static bool button_pressed = false;
-static bool last_button_state = true; // Pull-up, então estado inativo é HIGH
-static uint32_t last_debounce_time = 0;
-#define DEBOUNCE_DELAY 200 // ms
+#define BUTTON_EDGES (GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE)
 
 /**
- * Inicializa o botão especificado
- * 
- * @param pin Número do pino do botão
+ * Etapas do reconhecimento de gestos
  */
-void init_button(uint pin)
+typedef enum
 {
-    button_pin = pin;
-    
-    // Configura o pino como entrada com pull-up
-    gpio_init(button_pin);
-    gpio_set_dir(button_pin, GPIO_IN);
-    gpio_pull_up(button_pin);
+    GESTURE_IDLE,          ///< Solto
+    GESTURE_PRESSED,       ///< Primeiro toque, esperando o toque longo
+    GESTURE_LONG_HELD,     ///< Toque longo já emitido, esperando soltar
+    GESTURE_WAIT_SECOND,   ///< Solto depois de um toque curto, esperando o segundo
+    GESTURE_SECOND_PRESSED ///< Segundo toque, emitido ao soltar
+} GestureState;
+
+/**
+ * Estado de um botão (alterado só nas interrupções do núcleo que o iniciou)
+ */
+typedef struct
+{
+    uint pin;                  ///< Pino GPIO
+    bool configured;           ///< init_button() já foi chamada
+    bool pressed;              ///< Nível estável depois do debounce
+    GestureState state;        ///< Etapa do gesto
+    alarm_id_t debounce_alarm; ///< Alarme da janela de debounce (0 = nenhum)
+    alarm_id_t gesture_alarm;  ///< Alarme do toque longo ou do segundo toque (0 = nenhum)
+} Button;
+
+static Button buttons[BUTTON_COUNT];
+
+// Eventos: produtor nas interrupções, consumidor no laço principal
+static ButtonEvent event_storage[BUTTON_EVENT_QUEUE_SIZE];
+static SpscQueue event_queue;
+static bool queue_ready = false;
+
+static void emit(ButtonId id, ButtonGesture gesture)
+{
+    ButtonEvent event = {
+        .button = (uint8_t)id,
+        .gesture = (uint8_t)gesture,
+        .time_ms = to_ms_since_boot(get_absolute_time()),
+    };
+    spsc_queue_push(&event_queue, &event);
+    event_loop_post(EVENT_LOOP_BUTTON);
+}
+
+static int64_t on_gesture_timeout(alarm_id_t alarm, void *user_data);
+
+/**
+ * Troca o alarme de gesto de um botão
+ *
+ * @param button Botão
+ * @param delay_ms Prazo do novo alarme (0 = só cancela)
+ */
+static void gesture_alarm_set(Button *button, uint32_t delay_ms)
+{
+    if (button->gesture_alarm > 0)
+    {
+        cancel_alarm(button->gesture_alarm);
+        button->gesture_alarm = 0;
+    }
+    if (delay_ms)
+    {
+        alarm_id_t alarm = add_alarm_in_ms(delay_ms, on_gesture_timeout, (void *)(uintptr_t)(button - buttons), true);
+        button->gesture_alarm = alarm > 0 ? alarm : 0;
+    }
+}
+
+/**
+ * Avança o reconhecimento de gestos com um nível estável novo
+ */
+static void gesture_on_level(ButtonId id, bool pressed)
+{
+    Button *button = &buttons[id];
+
+    switch (button->state)
+    {
+    case GESTURE_IDLE:
+        if (pressed)
+        {
+            button->state = GESTURE_PRESSED;
+            gesture_alarm_set(button, BUTTON_LONG_PRESS_MS);
+        }
+        break;
+    case GESTURE_PRESSED:
+        if (!pressed)
+        {
+            button->state = GESTURE_WAIT_SECOND;
+            gesture_alarm_set(button, BUTTON_DOUBLE_CLICK_MS);
+        }
+        break;
+    case GESTURE_LONG_HELD:
+        if (!pressed)
+        {
+            button->state = GESTURE_IDLE;
+        }
+        break;
+    case GESTURE_WAIT_SECOND:
+        if (pressed)
+        {
+            button->state = GESTURE_SECOND_PRESSED;
+            gesture_alarm_set(button, 0);
+        }
+        break;
+    case GESTURE_SECOND_PRESSED:
+        if (!pressed)
+        {
+            button->state = GESTURE_IDLE;
+            emit(id, BUTTON_GESTURE_DOUBLE);
+        }
+        break;
+    }
+}
+
+/**
+ * Prazo do gesto: toque longo (ainda pressionado) ou toque curto (sem segundo toque)
+ */
+static int64_t on_gesture_timeout(alarm_id_t alarm, void *user_data)
+{
+    ButtonId id = (ButtonId)(uintptr_t)user_data;
+    Button *button = &buttons[id];
+    if (alarm != button->gesture_alarm)
+    {
+        return 0;
+    }
+    button->gesture_alarm = 0;
+
+    if (button->state == GESTURE_PRESSED)
+    {
+        button->state = GESTURE_LONG_HELD;
+        emit(id, BUTTON_GESTURE_LONG);
+    }
+    else if (button->state == GESTURE_WAIT_SECOND)
+    {
+        button->state = GESTURE_IDLE;
+        emit(id, BUTTON_GESTURE_SHORT);
+    }
+    return 0;
 }
 
 /**
- * Verifica o estado do botão com debouncing
- * 
- * @return true se o botão foi pressionado (evento único)
+ * Fim da janela de debounce: religa a interrupção e lê o nível estável
  */
-bool check_button(void)
+static int64_t on_debounce_timeout(alarm_id_t alarm, void *user_data)
 {
-    bool button_state = !gpio_get(button_pin); // Invertido porque é pull-up
-    uint32_t current_time = to_ms_since_boot(get_absolute_time());
+    ButtonId id = (ButtonId)(uintptr_t)user_data;
+    Button *button = &buttons[id];
+    button->debounce_alarm = 0;
+
+    // Religa antes de ler: uma borda depois da leitura abre outra janela
+    gpio_acknowledge_irq(button->pin, BUTTON_EDGES);
+    gpio_set_irq_enabled(button->pin, BUTTON_EDGES, true);
 
-    // Se o estado mudou, resetar o timer de debounce
-    if (button_state != last_button_state)
+    bool pressed = !gpio_get(button->pin); // Invertido porque é pull-up
+    if (pressed != button->pressed)
     {
-        last_debounce_time = current_time;
+        button->pressed = pressed;
+        gesture_on_level(id, pressed);
     }
+    return 0;
+}
 
-    // Se passado tempo suficiente desde a última mudança de estado
-    if ((current_time - last_debounce_time) > DEBOUNCE_DELAY)
+/**
+ * Interrupção de borda de qualquer botão: abre a janela de debounce
+ */
+static void on_button_edge(uint gpio, uint32_t events)
+{
+    (void)events;
+    for (int id = 0; id < BUTTON_COUNT; id++)
     {
-        // Se o botão está pressionado e isso ainda não foi registrado
-        if (button_state && !button_pressed)
+        Button *button = &buttons[id];
+        if (!button->configured || button->pin != gpio || button->debounce_alarm > 0)
         {
-            button_pressed = true;
-            last_button_state = button_state;
-            return true;
+            continue;
         }
-        // Se o botão foi solto
-        else if (!button_state && button_pressed)
+
+        // Os repiques da janela são ignorados; o nível é lido no fim dela
+        gpio_set_irq_enabled(gpio, BUTTON_EDGES, false);
+        alarm_id_t alarm = add_alarm_in_ms(BUTTON_DEBOUNCE_MS, on_debounce_timeout, (void *)(uintptr_t)id, true);
+        if (alarm > 0)
         {
-            button_pressed = false;
+            button->debounce_alarm = alarm;
         }
+        else
+        {
+            gpio_set_irq_enabled(gpio, BUTTON_EDGES, true);
+        }
+    }
+}
+
+/**
+ * Inicializa o botão especificado
+ *
+ * @param button Botão lógico
+ * @param pin Número do pino do botão
+ */
+void init_button(ButtonId button, uint pin)
+{
+    if (button >= BUTTON_COUNT)
+    {
+        return;
+    }
+    if (!queue_ready)
+    {
+        spsc_queue_init(&event_queue, event_storage, sizeof(ButtonEvent), BUTTON_EVENT_QUEUE_SIZE);
+        queue_ready = true;
     }
 
-    last_button_state = button_state;
-    return false;
-}
\ No newline at end of file
+    // Configura o pino como entrada com pull-up
+    gpio_init(pin);
+    gpio_set_dir(pin, GPIO_IN);
+    gpio_pull_up(pin);
+
+    Button *b = &buttons[button];
+    b->pin = pin;
+    b->pressed = false;
+    b->state = GESTURE_IDLE;
+    b->debounce_alarm = 0;
+    b->gesture_alarm = 0;
+    b->configured = true;
+
+    // Um único callback de GPIO por núcleo atende todos os botões
+    gpio_set_irq_enabled_with_callback(pin, BUTTON_EDGES, true, on_button_edge);
+}
+
+bool button_get_event(ButtonEvent *event)
+{
+    return queue_ready && spsc_queue_pop(&event_queue, event);
+}
+
+uint32_t button_get_dropped(void)
+{
+    return event_queue.dropped;
+}
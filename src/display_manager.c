@@ -1,19 +1,63 @@
 #include "inc/display_manager.h"
 #include "inc/audio_analyzer.h"
+#include "inc/audio_history.h"
+#include "inc/spectrum_analyzer.h"
+#include "inc/band_filter.h"
 #include "drivers/display-lcd/ssd1306.h"
 #include "drivers/display-lcd/ssd1306_fonts.h"
+#include "drivers/display-lcd/ssd1306_bitmaps.h"
+#include "inc/cycle_counter.h"
+#include "inc/probe.h"
 #include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
 
 /**
- * Exibe os resultados da análise de áudio no display OLED
+ * Camada com os elementos fixos de uma tela (títulos, divisórias, eixos)
+ * Desenhada uma vez e copiada por palavras no início de cada quadro
+ */
+typedef struct
+{
+    uint32_t pixels[SSD1306_BUFFER_SIZE / 4]; ///< Quadro pré-renderizado
+    void (*draw)(void);                       ///< Desenha os elementos fixos
+    bool ready;                               ///< Quadro já renderizado
+} DisplayLayer;
+
+// Com false, as telas desenham tudo a cada quadro (usado pelo benchmark)
+static bool display_layers_enabled = true;
+
+/**
+ * Começa um quadro a partir da camada de fundo da tela
  *
- * @param analysis Estrutura com os resultados da análise
+ * @param layer Camada da tela
  */
-void display_audio_monitor(AudioAnalysis analysis)
+static void layer_begin(DisplayLayer *layer)
 {
-    // Limpa o display
-    ssd1306_Fill(Black);
+    if (!display_layers_enabled)
+    {
+        ssd1306_Fill(Black);
+        layer->draw();
+        return;
+    }
 
+    if (!layer->ready)
+    {
+        ssd1306_Fill(Black);
+        layer->draw();
+        ssd1306_SaveFrame(layer->pixels);
+        layer->ready = true;
+        return;
+    }
+
+    ssd1306_LoadFrame(layer->pixels);
+}
+
+/**
+ * Elementos fixos do monitor: título, divisória e rótulo do medidor
+ */
+static void draw_monitor_chrome(void)
+{
     // === Seção 1: Monitor ===
     ssd1306_SetCursor(0, 0);
     ssd1306_WriteString("Monitor", Font_7x10, White);
@@ -21,15 +65,68 @@ void display_audio_monitor(AudioAnalysis analysis)
     // Desenha uma linha divisória
     ssd1306_Line(0, 12, 127, 12, White);
 
+    // === Seção 2: Medidor de Ruído ===
+    ssd1306_SetCursor(0, 36);
+    ssd1306_WriteString("Nivel de Ruido:", Font_7x10, White);
+}
+
+static DisplayLayer monitor_layer = {.draw = draw_monitor_chrome};
+
+// Ponderação no tempo do nível exibido pelo monitor (sempre com curva A)
+static SoundTimeWeighting monitor_time_weighting = SOUND_TIME_FAST;
+
+/**
+ * Escreve o símbolo da ponderação no tempo (F, S ou I) na posição do cursor
+ *
+ * Os caracteres são literais para que tools/font_pages.py os encontre.
+ *
+ * @param weighting Ponderação no tempo
+ */
+static void draw_time_symbol(SoundTimeWeighting weighting)
+{
+    switch (weighting)
+    {
+    case SOUND_TIME_SLOW:
+        ssd1306_WriteChar('S', Font_6x8, White);
+        break;
+    case SOUND_TIME_IMPULSE:
+        ssd1306_WriteChar('I', Font_6x8, White);
+        break;
+    default:
+        ssd1306_WriteChar('F', Font_6x8, White);
+        break;
+    }
+}
+
+// Tom detectado mostrado no status do monitor (0 = nenhum)
+static uint32_t monitor_tone_hz = 0;
+
+/**
+ * Desenha o monitor no framebuffer, sem enviar
+ *
+ * @param analysis Estrutura com os resultados da análise
+ */
+static void draw_audio_monitor(const AudioAnalysis *analysis)
+{
+    // Parte do quadro com os elementos fixos
+    layer_begin(&monitor_layer);
+
     // Exibe status do áudio
     ssd1306_SetCursor(0, 15);
-    if (analysis.is_clipping)
+    if (analysis->is_clipping)
     {
         ssd1306_WriteString("VOLUME ALTO!", Font_7x10, White);
         // Desenha indicador visual de alerta
         ssd1306_FillRectangle(110, 15, 127, 33, White);
     }
-    else if (analysis.is_low_volume)
+    else if (monitor_tone_hz)
+    {
+        char tone_str[16];
+        // Os tons monitorados cabem em 16 bits
+        snprintf(tone_str, sizeof(tone_str), "Tom %uHz", (unsigned)(uint16_t)monitor_tone_hz);
+        ssd1306_WriteString(tone_str, Font_7x10, White);
+    }
+    else if (analysis->is_low_volume)
     {
         ssd1306_WriteString("Volume Baixo", Font_7x10, White);
     }
@@ -38,18 +135,18 @@ void display_audio_monitor(AudioAnalysis analysis)
         ssd1306_WriteString("Audio OK", Font_7x10, White);
     }
 
-    // === Seção 2: Medidor de Ruído ===
-    ssd1306_SetCursor(0, 36);
-    ssd1306_WriteString("Nivel de Ruido:", Font_7x10, White);
-
-    // Mostra o valor estimado em dB, a tensão e o ruído de fundo para depuração
+    // Mostra o nível em dB(A) com a ponderação no tempo escolhida e a tensão para depuração
+    float level_db = analysis->weighted_db[SOUND_WEIGHTING_A][monitor_time_weighting];
     char info_str[32];
-    sprintf(info_str, "%.1fdB(%.2fV)", analysis.estimated_db, analysis.voltage);
+    sprintf(info_str, "%.1fdB(A)", level_db);
     ssd1306_SetCursor(0, 48);
     ssd1306_WriteString(info_str, Font_6x8, White);
+    draw_time_symbol(monitor_time_weighting);
+    sprintf(info_str, " %.2fV", analysis->voltage);
+    ssd1306_WriteString(info_str, Font_6x8, White);
 
     // Desenha barra de progresso para nível de ruído
-    uint8_t bar_width = (uint8_t)((analysis.estimated_db / 100.0f) * 128.0f);
+    uint8_t bar_width = (uint8_t)((level_db / 100.0f) * 128.0f);
     if (bar_width > 128)
         bar_width = 128;
 
@@ -57,13 +154,13 @@ void display_audio_monitor(AudioAnalysis analysis)
     ssd1306_FillRectangle(0, 57, bar_width, 63, White);
 
     // Escolhe os indicadores visuais baseados no nível de ruído
-    if (analysis.estimated_db < NOISE_THRESHOLD_LOW)
+    if (level_db < NOISE_THRESHOLD_LOW)
     {
         // Verde (silencioso) - barra normal
         ssd1306_SetCursor(100, 48);
         ssd1306_WriteString("SILC", Font_7x10, White);
     }
-    else if (analysis.estimated_db < NOISE_THRESHOLD_MEDIUM)
+    else if (level_db < NOISE_THRESHOLD_MEDIUM)
     {
         // Amarelo (moderado) - barra normal
         ssd1306_SetCursor(100, 48);
@@ -75,141 +172,820 @@ void display_audio_monitor(AudioAnalysis analysis)
         ssd1306_InvertRectangle(0, 57, bar_width, 63); // Inverte para destacar
     }
 
-    // Atualiza o display
-    ssd1306_UpdateScreen();
 }
 
 /**
- * Desenha um gráfico de volume e ruído no display
- * Redesenhado para mostrar tanto o sinal quanto o ruído
- * Com zoom aprimorado para melhor visualização
+ * Exibe os resultados da análise de áudio no display OLED
+ *
+ * @param analysis Estrutura com os resultados da análise
  */
-void display_volume_graph(void) {
-    // Limpa a tela
-    ssd1306_Fill(Black);
-    
-    // Título
+void display_audio_monitor(AudioAnalysis analysis)
+{
+    PROBE_BEGIN(PROBE_DISPLAY_MONITOR);
+    draw_audio_monitor(&analysis);
+    PROBE_END(PROBE_DISPLAY_MONITOR);
+}
+
+/**
+ * Escolhe a ponderação no tempo do nível mostrado pelo monitor
+ *
+ * @param weighting Fast, Slow ou Impulse
+ */
+void display_set_time_weighting(SoundTimeWeighting weighting)
+{
+    if (weighting < SOUND_TIME_COUNT)
+    {
+        monitor_time_weighting = weighting;
+    }
+}
+
+SoundTimeWeighting display_get_time_weighting(void)
+{
+    return monitor_time_weighting;
+}
+
+void display_set_tone(uint32_t frequency_hz)
+{
+    monitor_tone_hz = frequency_hz;
+}
+
+/**
+ * Converte um valor do histórico em coordenada Y do gráfico
+ *
+ * @param value Valor em Q15.16
+ * @param min_value Limite inferior da escala (Q15.16)
+ * @param range Amplitude da escala (Q15.16, maior que zero)
+ * @param top Linha superior da área do gráfico
+ * @param bottom Linha inferior da área do gráfico
+ * @return Coordenada Y limitada à área do gráfico
+ */
+static uint8_t graph_y(fx_q16_t value, fx_q16_t min_value, fx_q16_t range, uint8_t top, uint8_t bottom)
+{
+    // (value - min) cabe em ~18 bits e a altura em 6, então o produto cabe em 32 bits
+    int32_t y = bottom - ((value - min_value) * (bottom - top)) / range;
+    if (y < top) y = top;
+    if (y > bottom) y = bottom;
+    return (uint8_t)y;
+}
+
+/**
+ * Formata uma tensão Q15.16 com uma casa decimal, sem printf de float
+ *
+ * @param buf Buffer de saída
+ * @param size Tamanho do buffer
+ * @param value Tensão em Q15.16 (não negativa)
+ */
+static void format_volts(char *buf, size_t size, fx_q16_t value)
+{
+    int32_t tenths = (value * 10 + FX_ONE / 2) >> 16;
+    snprintf(buf, size, "%ld.%ldV", (long)(tenths / 10), (long)(tenths % 10));
+}
+
+// Área útil do gráfico: y de 15 a 62 (47 pixels de altura)
+#define GRAPH_TOP 15
+#define GRAPH_BOTTOM 62
+
+/**
+ * Elementos fixos do gráfico: título e eixos
+ */
+static void draw_graph_chrome(void)
+{
+    // Título (a janela de tempo é escrita à direita a cada quadro)
     ssd1306_SetCursor(0, 0);
-    ssd1306_WriteString("Grafico Vol+Ruido", Font_7x10, White);
-    
-    // Área útil do gráfico: y de 15 a 62 (47 pixels de altura)
-    const uint8_t graph_top = 15;
-    const uint8_t graph_bottom = 62;
-    const uint8_t graph_height = graph_bottom - graph_top;
-    
+    ssd1306_WriteString("Vol+Ruido", Font_7x10, White);
+
     // Desenhar eixos
-    ssd1306_Line(0, graph_bottom, 127, graph_bottom, White); // Eixo X
-    ssd1306_Line(0, graph_top, 0, graph_bottom, White);      // Eixo Y
-    
-    // Determinar valores mínimos e máximos para ajuste de escala
-    float min_value = 3.3f; // Inicializar com valor máximo possível
-    float max_value = 0.0f; // Inicializar com valor mínimo possível
-    
-    // Encontrar min/max para ajustar a escala automaticamente
-    for (int i = 0; i < HISTORY_SIZE; i++) {
-        int idx = (history_index + i) % HISTORY_SIZE;
-        
-        // Verificar valores de volume
-        if (voltage_history[idx] < min_value) min_value = voltage_history[idx];
-        if (voltage_history[idx] > max_value) max_value = voltage_history[idx];
-        
-        // Verificar valores de ruído
-        if (noise_floor_history[idx] < min_value) min_value = noise_floor_history[idx];
-        if (noise_floor_history[idx] > max_value) max_value = noise_floor_history[idx];
-    }
-    
+    ssd1306_Line(0, GRAPH_BOTTOM, 127, GRAPH_BOTTOM, White); // Eixo X
+    ssd1306_Line(0, GRAPH_TOP, 0, GRAPH_BOTTOM, White);      // Eixo Y
+}
+
+static DisplayLayer graph_layer = {.draw = draw_graph_chrome};
+
+// Linhas que rolam com o gráfico: os pontos de volume ficam uma linha acima da área
+#define GRAPH_PLOT_TOP (GRAPH_TOP - 1)
+#define GRAPH_PLOT_BOTTOM (GRAPH_BOTTOM - 1)
+
+// Passo da escala automática; os rótulos mostram a mesma casa decimal
+#define GRAPH_SCALE_STEP FX_FROM_FLOAT(0.1)
+
+// Resolução exibida e janela de tempo que ela cobre (HISTORY_SIZE entradas)
+static HistoryLevelId graph_level = HISTORY_LEVEL_BLOCK;
+static const char *graph_level_names[HISTORY_LEVEL_COUNT] = {"3s", "64s", "64min", "64h"};
+
+/**
+ * Quadro do gráfico sem as sobreposições (limiares e rótulos)
+ * A cada entrada nova o traçado é deslocado 2 colunas e só o trecho
+ * novo é desenhado; o redesenho completo fica para mudanças de escala
+ * ou de resolução
+ */
+typedef struct
+{
+    uint32_t pixels[SSD1306_BUFFER_SIZE / 4]; ///< Título, eixos e traçado
+    HistoryLevelId level;                     ///< Resolução desenhada
+    uint32_t count;                           ///< Entradas já desenhadas
+    fx_q16_t min_value;                       ///< Escala usada no traçado (Q15.16)
+    fx_q16_t max_value;
+    bool valid;                               ///< Quadro e escala desenhados
+} GraphCache;
+
+static GraphCache graph_cache;
+
+/**
+ * Extremos da resolução exibida, mantidos junto com as posições que os contêm
+ * Só uma entrada sobrescrita que era o próprio extremo exige nova varredura
+ */
+typedef struct
+{
+    history_code_t min_code;
+    history_code_t max_code;
+    int min_slot;
+    int max_slot;
+    HistoryLevelId level;
+    uint32_t count; ///< Entradas já consideradas
+    bool valid;
+} GraphExtremes;
+
+static GraphExtremes graph_extremes;
+
+/**
+ * Compara uma entrada (envelopes de volume e ruído) com os extremos
+ *
+ * @param history Nível exibido
+ * @param slot Posição da entrada
+ */
+static void graph_extremes_add(const HistoryLevel *history, int slot)
+{
+    history_code_t low = history->voltage_min[slot] < history->noise_min[slot] ? history->voltage_min[slot] : history->noise_min[slot];
+    history_code_t high = history->voltage_max[slot] > history->noise_max[slot] ? history->voltage_max[slot] : history->noise_max[slot];
+    if (low < graph_extremes.min_code)
+    {
+        graph_extremes.min_code = low;
+        graph_extremes.min_slot = slot;
+    }
+    if (high > graph_extremes.max_code)
+    {
+        graph_extremes.max_code = high;
+        graph_extremes.max_slot = slot;
+    }
+}
+
+/**
+ * Atualiza os extremos com as entradas fechadas desde a última chamada
+ *
+ * @param history Nível exibido
+ */
+static void graph_extremes_update(const HistoryLevel *history)
+{
+    uint32_t added = history->count - graph_extremes.count;
+    bool rescan = !graph_extremes.valid || graph_extremes.level != graph_level || added >= HISTORY_SIZE;
+
+    for (uint32_t n = added; n > 0 && !rescan; n--)
+    {
+        int slot = (history->index + HISTORY_SIZE - (int)n) % HISTORY_SIZE;
+        if (slot == graph_extremes.min_slot || slot == graph_extremes.max_slot)
+        {
+            // O extremo saiu da janela: só a varredura acha o próximo
+            rescan = true;
+        }
+        else
+        {
+            graph_extremes_add(history, slot);
+        }
+    }
+
+    if (rescan)
+    {
+        graph_extremes.min_code = HISTORY_CODE_MAX; // Inicializar com valor máximo possível
+        graph_extremes.max_code = 0;                // Inicializar com valor mínimo possível
+        graph_extremes.min_slot = graph_extremes.max_slot = -1;
+        for (int i = HISTORY_SIZE - audio_history_filled(history); i < HISTORY_SIZE; i++)
+        {
+            graph_extremes_add(history, audio_history_slot(history, i));
+        }
+        graph_extremes.level = graph_level;
+        graph_extremes.valid = true;
+    }
+    graph_extremes.count = history->count;
+}
+
+/**
+ * Calcula a escala do gráfico a partir dos extremos da resolução exibida
+ * Os limites são arredondados para GRAPH_SCALE_STEP, então pequenas
+ * variações dos extremos não obrigam a redesenhar o traçado
+ *
+ * @param history Nível exibido
+ * @param min_value Limite inferior (Q15.16)
+ * @param max_value Limite superior (Q15.16)
+ */
+static void graph_scale(const HistoryLevel *history, fx_q16_t *min_value, fx_q16_t *max_value)
+{
+    graph_extremes_update(history);
+    fx_q16_t low = 0;
+    fx_q16_t high = 0;
+    if (graph_extremes.min_slot >= 0)
+    {
+        low = HISTORY_CODE_TO_FX(graph_extremes.min_code);
+        high = HISTORY_CODE_TO_FX(graph_extremes.max_code);
+    }
+
     // Adicionar margem aos limites para melhor visualização
-    min_value = (min_value > 0.1f) ? min_value * 0.8f : 0.0f;
-    max_value = max_value * 1.1f;
-    
+    low = (low > FX_FROM_FLOAT(0.1)) ? fx_mul(low, FX_FROM_FLOAT(0.8)) : 0;
+    high = fx_mul(high, FX_FROM_FLOAT(1.1));
+
     // Garantir que a escala tenha um intervalo mínimo
-    if (max_value - min_value < 0.5f) {
-        float center = (max_value + min_value) / 2.0f;
-        max_value = center + 0.25f;
-        min_value = center - 0.25f;
+    if (high - low < FX_FROM_FLOAT(0.5)) {
+        fx_q16_t center = (high + low) / 2;
+        high = center + FX_FROM_FLOAT(0.25);
+        low = center - FX_FROM_FLOAT(0.25);
         // Certificar que não ficamos abaixo de zero
-        if (min_value < 0.0f) min_value = 0.0f;
+        if (low < 0) low = 0;
+    }
+
+    *min_value = (low / GRAPH_SCALE_STEP) * GRAPH_SCALE_STEP;
+    *max_value = ((high + GRAPH_SCALE_STEP - 1) / GRAPH_SCALE_STEP) * GRAPH_SCALE_STEP;
+}
+
+/**
+ * Converte um código do histórico em coordenada Y do gráfico
+ *
+ * @param code Código do histórico
+ * @param min_value Limite inferior da escala (Q15.16)
+ * @param range Amplitude da escala (Q15.16, maior que zero)
+ * @return Coordenada Y limitada à área do gráfico
+ */
+static uint8_t graph_code_y(history_code_t code, fx_q16_t min_value, fx_q16_t range)
+{
+    return graph_y(HISTORY_CODE_TO_FX(code), min_value, range, GRAPH_TOP, GRAPH_BOTTOM);
+}
+
+/**
+ * Desenha o trecho do traçado entre a entrada i e a i+1 (0 = mais antiga)
+ * O trecho ocupa as colunas 2i a 2i+2; entradas ainda vazias não são desenhadas
+ *
+ * @param history Nível exibido
+ * @param i Índice do trecho, de 0 a HISTORY_SIZE - 2
+ * @param min_value Limite inferior da escala (Q15.16)
+ * @param range Amplitude da escala (Q15.16)
+ */
+static void graph_draw_segment(const HistoryLevel *history, int i, fx_q16_t min_value, fx_q16_t range)
+{
+    if (i < HISTORY_SIZE - audio_history_filled(history))
+    {
+        return;
+    }
+
+    int current_idx = audio_history_slot(history, i);
+    int next_idx = audio_history_slot(history, i + 1);
+
+    int x1 = i * 2; // Usando 2 pixels por ponto para aumentar a resolução
+    int x2 = (i + 1) * 2;
+
+    // Ruído de fundo: área preenchida até o fundo, com a linha que conecta os pontos
+    uint8_t current_y = graph_code_y(history->noise_mean[current_idx], min_value, range);
+    uint8_t next_y = graph_code_y(history->noise_mean[next_idx], min_value, range);
+    ssd1306_Line(x1, current_y, x1, GRAPH_BOTTOM, White);
+    ssd1306_Line(x2, next_y, x2, GRAPH_BOTTOM, White);
+    ssd1306_Line(x1, current_y, x2, next_y, White);
+
+    // Volume: linha entre as médias, com um ponto acima de cada uma
+    current_y = graph_code_y(history->voltage_mean[current_idx], min_value, range);
+    next_y = graph_code_y(history->voltage_mean[next_idx], min_value, range);
+    ssd1306_Line(x1, current_y, x2, next_y, White);
+    ssd1306_DrawPixel(x1, current_y - 1, White);
+    ssd1306_DrawPixel(x2, next_y - 1, White);
+
+    // Nas resoluções agregadas, o envelope mínimo-máximo de cada entrada
+    if (graph_level != HISTORY_LEVEL_BLOCK)
+    {
+        ssd1306_Line(x1, graph_code_y(history->voltage_max[current_idx], min_value, range),
+                     x1, graph_code_y(history->voltage_min[current_idx], min_value, range), White);
+        ssd1306_Line(x2, graph_code_y(history->voltage_max[next_idx], min_value, range),
+                     x2, graph_code_y(history->voltage_min[next_idx], min_value, range), White);
+    }
+}
+
+/**
+ * Redesenha o traçado inteiro sobre a camada do título e dos eixos
+ *
+ * @param history Nível exibido
+ * @param min_value Limite inferior da escala (Q15.16)
+ * @param range Amplitude da escala (Q15.16)
+ */
+static void graph_draw_full(const HistoryLevel *history, fx_q16_t min_value, fx_q16_t range)
+{
+    layer_begin(&graph_layer);
+    for (int i = 0; i < HISTORY_SIZE - 1; i++)
+    {
+        graph_draw_segment(history, i, min_value, range);
+    }
+}
+
+/**
+ * Rola o traçado guardado pelas entradas novas
+ * Depois do deslocamento, a coluna 0 ainda tem o fim do trecho que saiu
+ * da janela: ela é apagada e o primeiro trecho redesenhado
+ *
+ * @param history Nível exibido
+ * @param added Entradas novas (menos que HISTORY_SIZE - 1)
+ * @param min_value Limite inferior da escala (Q15.16)
+ * @param range Amplitude da escala (Q15.16)
+ */
+static void graph_draw_scroll(const HistoryLevel *history, uint32_t added, fx_q16_t min_value, fx_q16_t range)
+{
+    ssd1306_LoadFrame(graph_cache.pixels);
+    ssd1306_ShiftLeft(GRAPH_PLOT_TOP, GRAPH_PLOT_BOTTOM, (uint8_t)(added * 2));
+
+    ssd1306_FillRectangle(0, GRAPH_PLOT_TOP, 0, GRAPH_PLOT_BOTTOM, Black);
+    ssd1306_Line(0, GRAPH_TOP, 0, GRAPH_BOTTOM, White); // Eixo Y
+    graph_draw_segment(history, 0, min_value, range);
+
+    for (int i = HISTORY_SIZE - 1 - (int)added; i < HISTORY_SIZE - 1; i++)
+    {
+        graph_draw_segment(history, i, min_value, range);
+    }
+}
+
+/**
+ * Desenha o gráfico de volume e ruído no framebuffer, sem enviar
+ * Redesenhado para mostrar tanto o sinal quanto o ruído
+ * Com zoom aprimorado para melhor visualização
+ * Toda a escala é calculada em ponto fixo (Q15.16)
+ */
+static void draw_volume_graph(void) {
+    const uint8_t graph_top = GRAPH_TOP;
+    const uint8_t graph_bottom = GRAPH_BOTTOM;
+    const HistoryLevel *history = audio_history_level(graph_level);
+
+    fx_q16_t min_value, max_value;
+    graph_scale(history, &min_value, &max_value);
+    const fx_q16_t range = max_value - min_value;
+
+    // Parte do traçado guardado quando a escala e a resolução não mudaram
+    uint32_t added = history->count - graph_cache.count;
+    if (!display_layers_enabled)
+    {
+        graph_draw_full(history, min_value, range);
+    }
+    else if (!graph_cache.valid || graph_cache.level != graph_level || min_value != graph_cache.min_value ||
+             max_value != graph_cache.max_value || added >= HISTORY_SIZE - 1)
+    {
+        graph_draw_full(history, min_value, range);
+        ssd1306_SaveFrame(graph_cache.pixels);
+        graph_cache.level = graph_level;
+        graph_cache.min_value = min_value;
+        graph_cache.max_value = max_value;
+        graph_cache.count = history->count;
+        graph_cache.valid = true;
     }
-    
+    else if (added > 0)
+    {
+        graph_draw_scroll(history, added, min_value, range);
+        ssd1306_SaveFrame(graph_cache.pixels);
+        graph_cache.count = history->count;
+    }
+    else
+    {
+        ssd1306_LoadFrame(graph_cache.pixels);
+    }
+
+    // Janela de tempo da resolução exibida, alinhada à direita
+    const char *window = graph_level_names[graph_level];
+    ssd1306_SetCursor(SSD1306_WIDTH - strlen(window) * Font_7x10.width, 0);
+    ssd1306_WriteString((char *)window, Font_7x10, White);
+
     // Calcular novas posições Y dos limiares com base na nova escala
-    uint8_t high_y = graph_top + (uint8_t)((1.0f - (VOLUME_THRESHOLD_HIGH - min_value) / (max_value - min_value)) * graph_height);
-    uint8_t low_y = graph_top + (uint8_t)((1.0f - (VOLUME_THRESHOLD_LOW - min_value) / (max_value - min_value)) * graph_height);
-    
-    // Garantir que os limiares estejam dentro dos limites visíveis
-    if (high_y < graph_top) high_y = graph_top;
-    if (high_y > graph_bottom) high_y = graph_bottom;
-    if (low_y < graph_top) low_y = graph_top;
-    if (low_y > graph_bottom) low_y = graph_bottom;
-    
+    uint8_t high_y = graph_y(FX_FROM_FLOAT(VOLUME_THRESHOLD_HIGH), min_value, range, graph_top, graph_bottom);
+    uint8_t low_y = graph_y(FX_FROM_FLOAT(VOLUME_THRESHOLD_LOW), min_value, range, graph_top, graph_bottom);
+
     // Desenhar linhas de referência
     ssd1306_Line(0, high_y, 127, high_y, White); // Linha de clipping
     ssd1306_Line(0, low_y, 127, low_y, White);   // Linha de volume baixo
-    
-    // Desenhar o gráfico de ruído de fundo (área preenchida inferior)
-    for (int i = 0; i < HISTORY_SIZE - 1; i++) {
-        int current_idx = (history_index + i) % HISTORY_SIZE;
-        int next_idx = (history_index + i + 1) % HISTORY_SIZE;
-        
-        // Normalizar para a nova escala ajustada
-        float current_noise = noise_floor_history[current_idx];
-        float next_noise = noise_floor_history[next_idx];
-        
-        // Converter para coordenadas Y com a nova escala (invertido, pois 0,0 é no canto superior esquerdo)
-        uint8_t current_y = graph_bottom - (uint8_t)(((current_noise - min_value) / (max_value - min_value)) * graph_height);
-        uint8_t next_y = graph_bottom - (uint8_t)(((next_noise - min_value) / (max_value - min_value)) * graph_height);
-        
-        // Garantir que está dentro dos limites
-        if (current_y < graph_top) current_y = graph_top;
-        if (next_y < graph_top) next_y = graph_top;
-        
-        // Desenhar área preenchida para o ruído de fundo
-        int x1 = i * 2; // Usando 2 pixels por ponto para aumentar a resolução
-        int x2 = (i + 1) * 2;
-        
-        // Desenhar linha vertical do ruído até o fundo
-        ssd1306_Line(x1, current_y, x1, graph_bottom, White);
-        ssd1306_Line(x2, next_y, x2, graph_bottom, White);
-        
-        // Desenhar linha horizontal para conectar os pontos de ruído
-        ssd1306_Line(x1, current_y, x2, next_y, White);
-    }
-    
-    // Desenhar o gráfico de volume principal (linha superior mais brilhante)
-    for (int i = 0; i < HISTORY_SIZE - 1; i++) {
-        int current_idx = (history_index + i) % HISTORY_SIZE;
-        int next_idx = (history_index + i + 1) % HISTORY_SIZE;
-        
-        // Normalizar para a nova escala ajustada
-        float current_val = voltage_history[current_idx];
-        float next_val = voltage_history[next_idx];
-        
-        // Converter para coordenadas Y com a nova escala
-        uint8_t current_y = graph_bottom - (uint8_t)(((current_val - min_value) / (max_value - min_value)) * graph_height);
-        uint8_t next_y = graph_bottom - (uint8_t)(((next_val - min_value) / (max_value - min_value)) * graph_height);
-        
-        // Garantir que está dentro dos limites
-        if (current_y < graph_top) current_y = graph_top;
-        if (next_y < graph_top) next_y = graph_top;
-        
-        // Desenhar linha entre pontos (linha mais espessa para o sinal principal)
-        int x1 = i * 2;
-        int x2 = (i + 1) * 2;
-        ssd1306_Line(x1, current_y, x2, next_y, White);
-        
-        // Desenhar pontos em cada amostra para melhor visualização
-        ssd1306_DrawPixel(x1, current_y - 1, White);
-        ssd1306_DrawPixel(x2, next_y - 1, White);
-    }
-    
+
     // Adicionar indicadores de escala
     char scale_buf[8];
-    sprintf(scale_buf, "%.1fV", max_value);
+    format_volts(scale_buf, sizeof(scale_buf), max_value);
     ssd1306_SetCursor(110, graph_top);
     ssd1306_WriteString(scale_buf, Font_6x8, White);
-    
-    sprintf(scale_buf, "%.1fV", min_value);
+
+    format_volts(scale_buf, sizeof(scale_buf), min_value);
     ssd1306_SetCursor(110, graph_bottom - 8);
     ssd1306_WriteString(scale_buf, Font_6x8, White);
-    
-    ssd1306_UpdateScreen();
-}
\ No newline at end of file
+}
+
+/**
+ * Desenha um gráfico de volume e ruído no display
+ */
+void display_volume_graph(void) {
+    PROBE_BEGIN(PROBE_DISPLAY_GRAPH);
+    draw_volume_graph();
+    PROBE_END(PROBE_DISPLAY_GRAPH);
+}
+
+/**
+ * Passa o gráfico para a próxima resolução do histórico, voltando à
+ * mais fina depois da última
+ */
+void display_graph_next_scale(void)
+{
+    graph_level = (graph_level + 1) % HISTORY_LEVEL_COUNT;
+}
+
+// Tela de espectro: 32 barras de 3 pixels com 1 pixel de espaço
+#define SPECTRUM_BARS 32
+#define SPECTRUM_BAR_WIDTH 3
+#define SPECTRUM_TOP 12
+#define SPECTRUM_BOTTOM 63
+
+// Faixa exibida em log2 da magnitude (~6 dB por unidade):
+// 1 fica perto do ruído de quantização e 12 corresponde ao fundo de escala do ADC
+#define SPECTRUM_LOG2_FLOOR FX_FROM_INT(1)
+#define SPECTRUM_LOG2_CEIL FX_FROM_INT(12)
+
+static uint16_t spectrum_band_edges[SPECTRUM_BARS + 1];
+static uint16_t spectrum_band_bins = 0; // Número de raias para o qual as bordas foram calculadas
+
+/**
+ * Calcula as bordas das bandas, com largura logarítmica entre a raia 1 e a última
+ * Executada só quando o tamanho da FFT muda, então o uso de float é pontual
+ *
+ * @param bins Número de raias do espectro
+ */
+static void init_spectrum_bands(uint16_t bins)
+{
+    float ratio = powf((float)bins, 1.0f / SPECTRUM_BARS);
+    float edge = 1.0f;
+
+    spectrum_band_edges[0] = 1; // A raia 0 (DC) fica de fora
+    for (int b = 1; b < SPECTRUM_BARS; b++)
+    {
+        edge *= ratio;
+        uint16_t value = (uint16_t)edge;
+        // Cada banda tem pelo menos uma raia
+        if (value <= spectrum_band_edges[b - 1])
+        {
+            value = spectrum_band_edges[b - 1] + 1;
+        }
+        spectrum_band_edges[b] = value;
+    }
+    spectrum_band_edges[SPECTRUM_BARS] = bins;
+    spectrum_band_bins = bins;
+}
+
+/**
+ * Elementos fixos do espectro: título
+ */
+static void draw_spectrum_chrome(void)
+{
+    ssd1306_SetCursor(0, 0);
+    ssd1306_WriteString("Espectro", Font_7x10, White);
+}
+
+static DisplayLayer spectrum_layer = {.draw = draw_spectrum_chrome};
+
+/**
+ * Desenha o espectro em barras no framebuffer, sem enviar
+ * Cada barra mostra a maior magnitude da sua banda, em escala logarítmica
+ */
+static void draw_spectrum(void)
+{
+    const uint16_t bins = spectrum_get_bin_count();
+    const uint16_t *magnitudes = spectrum_get_magnitudes();
+    const int32_t height = SPECTRUM_BOTTOM - SPECTRUM_TOP;
+
+    if (spectrum_band_bins != bins)
+    {
+        init_spectrum_bands(bins);
+    }
+
+    // Parte do quadro com o título
+    layer_begin(&spectrum_layer);
+
+    // Carga da FFT (porcentagem do orçamento de ciclos por quadro)
+    SpectrumStats stats;
+    spectrum_get_stats(&stats);
+    char load_str[8];
+    uint32_t load = stats.budget_cycles ? (stats.last_cycles * 100u) / stats.budget_cycles : 0;
+    if (load > 999)
+        load = 999; // Cabe no canto da tela (e no buffer)
+    snprintf(load_str, sizeof(load_str), "%u%%", (unsigned)load);
+    ssd1306_SetCursor(100, 0);
+    ssd1306_WriteString(load_str, Font_6x8, White);
+
+    for (int b = 0; b < SPECTRUM_BARS; b++)
+    {
+        // Pico da banda
+        uint16_t peak = 0;
+        for (uint16_t k = spectrum_band_edges[b]; k < spectrum_band_edges[b + 1]; k++)
+        {
+            if (magnitudes[k] > peak)
+                peak = magnitudes[k];
+        }
+        if (peak == 0)
+            continue;
+
+        // Altura proporcional ao nível em dB dentro da faixa exibida
+        fx_q16_t level = fx_log2(peak) - SPECTRUM_LOG2_FLOOR;
+        if (level <= 0)
+            continue;
+        int32_t bar = (level * height) / (SPECTRUM_LOG2_CEIL - SPECTRUM_LOG2_FLOOR);
+        if (bar > height)
+            bar = height;
+
+        uint8_t x = b * (SPECTRUM_BAR_WIDTH + 1);
+        ssd1306_FillRectangle(x, SPECTRUM_BOTTOM - bar, x + SPECTRUM_BAR_WIDTH - 1, SPECTRUM_BOTTOM, White);
+    }
+}
+
+/**
+ * Desenha o espectro em barras no display
+ */
+void display_spectrum(void)
+{
+    draw_spectrum();
+}
+
+// Tela de bandas: a largura é dividida igualmente entre as bandas
+#define BANDS_TOP 12
+#define BANDS_BOTTOM 54
+#define BANDS_LABEL_Y 56
+
+// Faixa exibida, na escala de estimated_db
+#define BANDS_DB_FLOOR FX_FROM_INT(30)
+#define BANDS_DB_CEIL FX_FROM_INT(110)
+
+// Modo e número de bandas para os quais a camada foi desenhada
+static uint8_t bands_chrome_mode = BAND_FILTER_OCTAVE;
+static uint8_t bands_chrome_count = 0;
+
+/**
+ * Largura reservada para cada banda e margem esquerda para centralizar as barras
+ */
+static uint8_t bands_pitch(void)
+{
+    return bands_chrome_count ? SSD1306_WIDTH / bands_chrome_count : SSD1306_WIDTH;
+}
+
+static uint8_t bands_margin(void)
+{
+    return (SSD1306_WIDTH - bands_pitch() * bands_chrome_count) / 2;
+}
+
+/**
+ * Escreve a frequência central de uma banda embaixo da sua barra
+ *
+ * @param band Índice da banda
+ */
+static void draw_band_label(uint8_t band)
+{
+    char label[8];
+    uint32_t hz = band_filter_center_hz(band);
+    // As frequências centrais cabem em 16 bits
+    if (hz >= 1000)
+        snprintf(label, sizeof(label), "%uk", (unsigned)(uint16_t)(hz / 1000));
+    else
+        snprintf(label, sizeof(label), "%u", (unsigned)hz);
+
+    // Centralizado na barra, sem sair da tela
+    int32_t width = (int32_t)strlen(label) * 6;
+    int32_t x = bands_margin() + band * bands_pitch() + bands_pitch() / 2 - width / 2;
+    if (x < 0)
+        x = 0;
+    if (x > SSD1306_WIDTH - width)
+        x = SSD1306_WIDTH - width;
+    ssd1306_SetCursor((uint8_t)x, BANDS_LABEL_Y);
+    ssd1306_WriteString(label, Font_6x8, White);
+}
+
+/**
+ * Elementos fixos das bandas: título e frequências das pontas e de 1 kHz
+ */
+static void draw_bands_chrome(void)
+{
+    ssd1306_SetCursor(0, 0);
+    if (bands_chrome_mode == BAND_FILTER_THIRD_OCTAVE)
+        ssd1306_WriteString("Bandas 1/3", Font_7x10, White);
+    else
+        ssd1306_WriteString("Oitavas", Font_7x10, White);
+
+    if (bands_chrome_count == 0)
+        return;
+
+    // Banda mais próxima de 1 kHz (as centrais são 1000 * 2^(n/3))
+    uint8_t reference = 0;
+    while (reference + 1 < bands_chrome_count && band_filter_center_hz(reference) < 1000)
+        reference++;
+
+    draw_band_label(0);
+    draw_band_label(reference);
+    draw_band_label(bands_chrome_count - 1);
+}
+
+static DisplayLayer bands_layer = {.draw = draw_bands_chrome};
+
+/**
+ * Desenha os níveis das bandas em barras no framebuffer, sem enviar
+ *
+ * @param bands Níveis do último período
+ */
+static void draw_bands(const BandLevels *bands)
+{
+    const int32_t height = BANDS_BOTTOM - BANDS_TOP;
+
+    // A camada depende do modo e do número de bandas do banco de filtros
+    if (bands->mode != bands_chrome_mode || bands->count != bands_chrome_count)
+    {
+        bands_chrome_mode = bands->mode;
+        bands_chrome_count = bands->count;
+        bands_layer.ready = false;
+    }
+    layer_begin(&bands_layer);
+
+    // Banda mais alta no canto do título
+    fx_q16_t peak = 0;
+    for (int b = 0; b < bands->count; b++)
+    {
+        if (bands->db[b] > peak)
+            peak = bands->db[b];
+    }
+    char peak_str[12];
+    snprintf(peak_str, sizeof(peak_str), "%.0fdB", FX_TO_FLOAT(peak));
+    ssd1306_SetCursor(SSD1306_WIDTH - (uint8_t)strlen(peak_str) * 6, 0);
+    ssd1306_WriteString(peak_str, Font_6x8, White);
+
+    uint8_t pitch = bands_pitch();
+    uint8_t margin = bands_margin();
+    for (int b = 0; b < bands->count; b++)
+    {
+        fx_q16_t level = bands->db[b] - BANDS_DB_FLOOR;
+        if (level <= 0)
+            continue;
+        int32_t bar = (int32_t)(((int64_t)level * height) / (BANDS_DB_CEIL - BANDS_DB_FLOOR));
+        if (bar > height)
+            bar = height;
+
+        uint8_t x = margin + b * pitch;
+        ssd1306_FillRectangle(x, BANDS_BOTTOM - bar, x + pitch - 2, BANDS_BOTTOM, White);
+    }
+}
+
+/**
+ * Desenha os níveis das bandas no display
+ *
+ * @param bands Níveis do último período
+ */
+void display_bands(const BandLevels *bands)
+{
+    draw_bands(bands);
+}
+
+/**
+ * Envia o quadro desenhado ao display
+ */
+void display_flush(void)
+{
+    // Envia por DMA só as janelas alteradas; o próximo quadro já pode ser desenhado
+    ssd1306_UpdateScreenAsync();
+}
+
+// Versões pixel a pixel das primitivas, usadas como referência no benchmark
+
+static void bench_fill_pixels(uint8_t x1, uint8_t y1, uint8_t x2, uint8_t y2)
+{
+    for (uint8_t y = y1; y <= y2; y++)
+        for (uint8_t x = x1; x <= x2; x++)
+            ssd1306_DrawPixel(x, y, White);
+}
+
+static void bench_bitmap_pixels(const unsigned char *bitmap, uint8_t w, uint8_t h)
+{
+    uint8_t byte = 0;
+    for (uint8_t j = 0; j < h; j++)
+    {
+        for (uint8_t i = 0; i < w; i++)
+        {
+            byte = (i & 7) ? byte << 1 : bitmap[j * ((w + 7) / 8) + i / 8];
+            if (byte & 0x80)
+                ssd1306_DrawPixel(i, j, White);
+        }
+    }
+}
+
+static bool bench_glyph_pixel(SSD1306_Font_t font, char ch, uint8_t row, uint8_t col)
+{
+    if (font.pages)
+    {
+        uint32_t index = font.remap ? font.remap[ch - 32] : (uint32_t)(ch - 32);
+        const uint8_t *glyph = &font.pages[index * ((font.height + 7) / 8) * font.width];
+        return glyph[(row / 8) * font.width + col] & (1 << (row % 8));
+    }
+    return (font.data[(ch - 32) * font.height + row] << col) & 0x8000;
+}
+
+static void bench_string_pixels(const char *str, SSD1306_Font_t font)
+{
+    for (uint8_t x = 0; *str; str++, x += font.width)
+    {
+        for (uint8_t i = 0; i < font.height; i++)
+            for (uint8_t j = 0; j < font.width; j++)
+                ssd1306_DrawPixel(x + j, i, bench_glyph_pixel(font, *str, i, j) ? White : Black);
+    }
+}
+
+/**
+ * Compara o custo das primitivas de desenho pixel a pixel com os
+ * caminhos por bytes e palavras do driver, e o de cada tela sem e com
+ * a camada de fundo, e imprime os ciclos gastos
+ *
+ * @param iterations Número de repetições de cada primitiva
+ */
+void display_benchmark(uint32_t iterations)
+{
+    if (iterations == 0)
+    {
+        return;
+    }
+
+    cycle_counter_init();
+
+    static const char *names[] = {"tela cheia", "barra", "linha vertical", "bitmap", "texto"};
+    uint32_t pixel_cycles[5] = {0};
+    uint32_t span_cycles[5] = {0};
+
+    for (uint32_t n = 0; n < iterations; n++)
+    {
+        uint32_t start = cycle_counter_now();
+        bench_fill_pixels(0, 0, SSD1306_WIDTH - 1, SSD1306_HEIGHT - 1);
+        pixel_cycles[0] += cycle_counter_elapsed(start);
+        start = cycle_counter_now();
+        ssd1306_FillRectangle(0, 0, SSD1306_WIDTH - 1, SSD1306_HEIGHT - 1, White);
+        span_cycles[0] += cycle_counter_elapsed(start);
+
+        start = cycle_counter_now();
+        bench_fill_pixels(10, 50, 100, 60);
+        pixel_cycles[1] += cycle_counter_elapsed(start);
+        start = cycle_counter_now();
+        ssd1306_FillRectangle(10, 50, 100, 60, White);
+        span_cycles[1] += cycle_counter_elapsed(start);
+
+        start = cycle_counter_now();
+        bench_fill_pixels(64, 3, 64, 60);
+        pixel_cycles[2] += cycle_counter_elapsed(start);
+        start = cycle_counter_now();
+        ssd1306_Line(64, 3, 64, 60, White);
+        span_cycles[2] += cycle_counter_elapsed(start);
+
+        start = cycle_counter_now();
+        bench_bitmap_pixels(virtuscc_bitmap, SSD1306_WIDTH, SSD1306_HEIGHT);
+        pixel_cycles[3] += cycle_counter_elapsed(start);
+        start = cycle_counter_now();
+        ssd1306_DrawBitmap(0, 0, virtuscc_bitmap, SSD1306_WIDTH, SSD1306_HEIGHT, White);
+        span_cycles[3] += cycle_counter_elapsed(start);
+
+        start = cycle_counter_now();
+        bench_string_pixels("Nivel de Ruido:", Font_7x10);
+        pixel_cycles[4] += cycle_counter_elapsed(start);
+        start = cycle_counter_now();
+        ssd1306_SetCursor(0, 0);
+        ssd1306_WriteString("Nivel de Ruido:", Font_7x10, White);
+        span_cycles[4] += cycle_counter_elapsed(start);
+    }
+
+    for (int i = 0; i < 5; i++)
+    {
+        uint32_t pixel = pixel_cycles[i] / iterations;
+        uint32_t span = span_cycles[i] / iterations;
+        printf("%-15s pixel %6lu ciclos | span %6lu ciclos (%lu.%lux)\n", names[i],
+               (unsigned long)pixel, (unsigned long)span,
+               (unsigned long)(pixel / span), (unsigned long)((pixel * 10 / span) % 10));
+    }
+
+    // Telas completas sem e com as camadas de fundo (sem o envio ao display)
+    static const char *screens[] = {"monitor", "grafico", "espectro"};
+    AudioAnalysis analysis = {.voltage = 1.2f, .estimated_db = 55.0f};
+    analysis.weighted_db[SOUND_WEIGHTING_A][SOUND_TIME_FAST] = 55.0f;
+    for (int i = 0; i < 3; i++)
+    {
+        uint32_t cycles[2] = {0};
+        for (int layers = 0; layers < 2; layers++)
+        {
+            display_layers_enabled = layers;
+            for (uint32_t n = 0; n < iterations; n++)
+            {
+                uint32_t start = cycle_counter_now();
+                if (i == 0)
+                    draw_audio_monitor(&analysis);
+                else if (i == 1)
+                    draw_volume_graph();
+                else
+                    draw_spectrum();
+                cycles[layers] += cycle_counter_elapsed(start);
+            }
+            cycles[layers] /= iterations;
+        }
+        printf("tela %-10s sem camada %6lu ciclos | com camada %6lu ciclos\n", screens[i],
+               (unsigned long)cycles[0], (unsigned long)cycles[1]);
+    }
+    display_layers_enabled = true;
+
+    ssd1306_Fill(Black);
+}
@@ -0,0 +1,113 @@
+#include "inc/dsp_core.h"
+#include "inc/dsp_pipeline.h"
+#include "inc/spectrum_analyzer.h"
+#include "inc/spsc_queue.h"
+#include "inc/event_loop.h"
+#include "drivers/mic/mic.h"
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+
+// Valor enviado pela FIFO entre núcleos quando o núcleo 1 está pronto
+#define DSP_CORE_READY 1u
+
+// Fila de resultados: produtor no núcleo 1, consumidor no núcleo 0
+static AudioAnalysisFx result_storage[DSP_RESULT_QUEUE_SIZE];
+static SpscQueue result_queue;
+
+// Contadores escritos pelo núcleo 1
+static volatile uint32_t results_published = 0;
+
+// Contadores escritos pelo núcleo 0
+static uint32_t results_received = 0;
+static uint32_t results_coalesced = 0;
+
+/**
+ * Publica o resultado de um período para o núcleo 0
+ */
+static void publish_result(const AudioAnalysisFx *analysis)
+{
+    if (spsc_queue_push(&result_queue, analysis))
+    {
+        results_published++;
+    }
+    // Acorda o núcleo 0 (também para os tons detectados desde o último resultado)
+    event_loop_post(EVENT_LOOP_DSP_RESULT);
+}
+
+/**
+ * Laço do núcleo 1: analisa todos os blocos capturados e publica um
+ * resultado por período de análise
+ */
+static void dsp_core_entry(void)
+{
+    // A interrupção do DMA fica no núcleo que inicia a captura
+    dsp_pipeline_init();
+
+#ifdef MIC_MONITOR_BENCHMARK
+    // Compara o custo da análise em float e em ponto fixo
+    audio_analyzer_benchmark(100);
+#endif
+
+    multicore_fifo_push_blocking(DSP_CORE_READY);
+
+    while (1)
+    {
+        dsp_pipeline_process_block(publish_result);
+    }
+}
+
+/**
+ * Inicia o núcleo 1 e espera que a captura esteja rodando
+ */
+void dsp_core_start(void)
+{
+    spsc_queue_init(&result_queue, result_storage, sizeof(AudioAnalysisFx), DSP_RESULT_QUEUE_SIZE);
+
+    multicore_launch_core1(dsp_core_entry);
+
+    // O histórico foi iniciado pelo núcleo 1; depois disto só o núcleo 0 o altera
+    while (multicore_fifo_pop_blocking() != DSP_CORE_READY)
+    {
+        tight_loop_contents();
+    }
+}
+
+/**
+ * Retira o próximo resultado da fila
+ *
+ * @param analysis Destino do resultado
+ * @return true se havia resultado
+ */
+bool dsp_core_receive(AudioAnalysisFx *analysis)
+{
+    if (!spsc_queue_pop(&result_queue, analysis))
+    {
+        return false;
+    }
+    results_received++;
+    return true;
+}
+
+void dsp_core_note_coalesced(uint32_t count)
+{
+    results_coalesced += count;
+}
+
+/**
+ * Reúne os contadores dos dois núcleos
+ *
+ * @param counters Estrutura de saída
+ */
+void dsp_core_get_counters(DspCoreCounters *counters)
+{
+    SpectrumStats spectrum;
+    spectrum_get_stats(&spectrum);
+
+    counters->blocks_captured = mic_get_block_count();
+    counters->blocks_dropped = mic_get_dropped_blocks();
+    counters->spectrum_dropped = spectrum.dropped;
+    counters->results_published = results_published;
+    counters->results_dropped = result_queue.dropped;
+    counters->results_received = results_received;
+    counters->results_coalesced = results_coalesced;
+}
@@ -0,0 +1,63 @@
+#include "inc/dsp_pipeline.h"
+#include "inc/spectrum_analyzer.h"
+#include "inc/sound_level.h"
+#include "inc/band_filter.h"
+#include "inc/tone_detector.h"
+#include "inc/probe.h"
+#include "drivers/mic/mic.h"
+
+// Tons monitorados: tom de teste de 1 kHz e alarmes de fumaça de 2,7 a 3,2 kHz
+// (cada detector cobre ~240 Hz, então três cobrem a faixa dos alarmes)
+static const ToneDetectorConfig tone_configs[] = {
+    {"teste 1 kHz", 1000, FX_FROM_FLOAT(0.5), FX_FROM_FLOAT(0.3), 300},
+    {"alarme 2,8 kHz", 2800, FX_FROM_FLOAT(0.3), FX_FROM_FLOAT(0.15), 200},
+    {"alarme 3,0 kHz", 3000, FX_FROM_FLOAT(0.3), FX_FROM_FLOAT(0.15), 200},
+    {"alarme 3,2 kHz", 3200, FX_FROM_FLOAT(0.3), FX_FROM_FLOAT(0.15), 200},
+};
+
+/**
+ * Recebe cada bloco da captura contínua (interrupção do DMA)
+ */
+static void on_mic_block(const uint16_t *block, uint32_t count)
+{
+    // Monta os quadros da FFT sem intervalos entre blocos
+    spectrum_push_samples(block, count);
+}
+
+void dsp_pipeline_init(void)
+{
+    mic_init();
+    probe_init();
+    spectrum_init(SPECTRUM_FFT_SIZE);
+    sound_level_init();
+    band_filter_init(BAND_FILTER_DEFAULT_MODE);
+    tone_detector_init(tone_configs, sizeof(tone_configs) / sizeof(tone_configs[0]));
+    mic_start_capture(on_mic_block);
+
+    // Histórico vazio; só períodos completos de análise entram nele
+    init_audio_history();
+}
+
+void dsp_pipeline_process_block(DspResultHandler on_result)
+{
+    // Espera o próximo bloco; as estatísticas saem da mesma passada
+    mic_sample();
+    PROBE_BEGIN(PROBE_DSP_BLOCK);
+
+    // Ponderações A/C amostra a amostra, sem pular nenhum bloco
+    sound_level_process(mic_get_buffer(), SAMPLES);
+    band_filter_process(mic_get_buffer(), SAMPLES);
+    tone_detector_process(mic_get_buffer(), mic_get_stats());
+
+    AudioAnalysisFx analysis;
+    if (audio_analyzer_push_block(mic_get_stats(), &analysis))
+    {
+        sound_level_get(&analysis.levels);
+        band_filter_get(&analysis.bands);
+        on_result(&analysis);
+    }
+
+    // Processa o quadro da FFT que a captura tiver completado
+    spectrum_process();
+    PROBE_END(PROBE_DSP_BLOCK);
+}
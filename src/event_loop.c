@@ -0,0 +1,92 @@
+#include "inc/event_loop.h"
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include "hardware/sync.h"
+
+// Um byte por evento: cada post só escreve 1 e só o laço escreve 0, então
+// os dois núcleos não precisam de spinlock (o M0+ não tem leitura-escrita atômica)
+static volatile uint8_t pending[EVENT_LOOP_COUNT];
+
+// Atividade do período atual (só o núcleo 0 escreve)
+static uint32_t period_start_us = 0;
+static uint32_t idle_us = 0;
+static uint32_t wakeups = 0;
+static uint32_t delivered = 0;
+
+void event_loop_post(EventLoopEvent event)
+{
+    if (event >= EVENT_LOOP_COUNT)
+    {
+        return;
+    }
+    pending[event] = 1;
+    // Acorda o outro núcleo; no próprio núcleo a entrada na interrupção já basta
+    __sev();
+}
+
+/**
+ * Recolhe e limpa os sinalizadores
+ *
+ * Um post entre a leitura e a limpeza se junta ao que está sendo
+ * entregue, que ainda vai ser tratado depois da limpeza.
+ */
+static uint32_t take_pending(void)
+{
+    uint32_t events = 0;
+    for (int e = 0; e < EVENT_LOOP_COUNT; e++)
+    {
+        if (pending[e])
+        {
+            pending[e] = 0;
+            events |= EVENT_LOOP_MASK(e);
+            delivered++;
+        }
+    }
+    return events;
+}
+
+/**
+ * Dorme até o próximo evento
+ *
+ * @return Máscara dos eventos pendentes
+ */
+uint32_t event_loop_wait(void)
+{
+    uint32_t events = take_pending();
+    if (events)
+    {
+        return events;
+    }
+
+    // Sem corrida entre a verificação e o __wfe: um post ou uma interrupção
+    // nesse intervalo deixa o registrador de evento ligado e o __wfe retorna na hora
+    uint32_t sleep_start = time_us_32();
+    do
+    {
+        __wfe();
+        wakeups++;
+        events = take_pending();
+    } while (!events);
+    idle_us += time_us_32() - sleep_start;
+
+    return events;
+}
+
+/**
+ * Lê a atividade do período e zera os acumuladores
+ *
+ * @param stats Estrutura de saída
+ */
+void event_loop_get_stats(EventLoopStats *stats)
+{
+    uint32_t now = time_us_32();
+    stats->elapsed_us = now - period_start_us;
+    stats->idle_us = idle_us;
+    stats->wakeups = wakeups;
+    stats->events = delivered;
+
+    period_start_us = now;
+    idle_us = 0;
+    wakeups = 0;
+    delivered = 0;
+}
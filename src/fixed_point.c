@@ -0,0 +1,144 @@
+#include "inc/fixed_point.h"
+
+// log2(1 + i/32) em Q15.16, i = 0..32
+static const uint32_t log2_mantissa_table[33] = {
+    0, 2909, 5732, 8473, 11136, 13727, 16248, 18704,
+    21098, 23433, 25711, 27936, 30109, 32234, 34312, 36346,
+    38336, 40286, 42196, 44068, 45904, 47705, 49472, 51207,
+    52911, 54584, 56229, 57845, 59434, 60997, 62534, 64047,
+    65536,
+};
+
+// 2^(i/32) em Q15.16, i = 0..32
+static const uint32_t exp2_mantissa_table[33] = {
+    65536, 66971, 68438, 69936, 71468, 73032, 74632, 76266,
+    77936, 79642, 81386, 83169, 84990, 86851, 88752, 90696,
+    92682, 94711, 96785, 98905, 101070, 103283, 105545, 107856,
+    110218, 112631, 115098, 117618, 120194, 122825, 125515, 128263,
+    131072,
+};
+
+// 20 * log10(2) em Q15.16
+#define FX_DB_PER_OCTAVE 394566
+
+// log2(10) / 10 em Q15.16: oitavas de potência por dB
+#define FX_OCTAVES_PER_DB 21771
+
+/**
+ * Raiz quadrada inteira pelo método dígito a dígito
+ *
+ * @param value Valor de entrada
+ * @return Parte inteira da raiz quadrada
+ */
+uint32_t fx_isqrt(uint32_t value)
+{
+    uint32_t root = 0;
+    uint32_t bit = 1u << 30;
+
+    while (bit > value)
+    {
+        bit >>= 2;
+    }
+    while (bit)
+    {
+        if (value >= root + bit)
+        {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else
+        {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+/**
+ * Calcula log2 de um inteiro em Q15.16
+ *
+ * @param value Valor de entrada (maior que zero)
+ * @return log2(value) em Q15.16
+ */
+fx_q16_t fx_log2(uint32_t value)
+{
+    if (value == 0)
+    {
+        return INT32_MIN;
+    }
+
+    // Parte inteira: posição do bit mais significativo
+    int32_t exponent = 31 - __builtin_clz(value);
+
+    // Normaliza a mantissa para [2^31, 2^32)
+    uint32_t mantissa = value << (31 - exponent);
+
+    // 5 bits seguintes indexam a tabela, os 26 restantes interpolam
+    uint32_t index = (mantissa >> 26) & 0x1F;
+    uint32_t frac = (mantissa >> 10) & 0xFFFF;
+    uint32_t lo = log2_mantissa_table[index];
+    uint32_t hi = log2_mantissa_table[index + 1];
+
+    return (exponent << 16) + (fx_q16_t)(lo + (((hi - lo) * frac) >> 16));
+}
+
+/**
+ * Converte uma amplitude em dB usando 20*log10(x) = 20*log10(2) * log2(x)
+ *
+ * @param amplitude Amplitude em Q15.16 (maior que zero)
+ * @return Nível em dB em Q15.16
+ */
+fx_q16_t fx_amplitude_to_db(fx_q16_t amplitude)
+{
+    // log2 do valor bruto inclui os 16 bits fracionários do formato
+    fx_q16_t log2_value = fx_log2((uint32_t)amplitude) - FX_FROM_INT(16);
+    return fx_mul(log2_value, FX_DB_PER_OCTAVE);
+}
+
+/**
+ * Converte uma potência em dB usando 10*log10(x) = 10*log10(2) * log2(x)
+ * Valores acima de 32 bits são deslocados antes do log2, e o deslocamento
+ * volta como parte inteira do logaritmo
+ *
+ * @param power Potência com frac_bits bits fracionários (maior que zero)
+ * @param frac_bits Bits fracionários de power
+ * @return Nível em dB em Q15.16
+ */
+fx_q16_t fx_power_to_db(uint64_t power, uint32_t frac_bits)
+{
+    int32_t shift = 0;
+    while (power >> 32)
+    {
+        power >>= 1;
+        shift++;
+    }
+    fx_q16_t log2_value = fx_log2((uint32_t)power) + FX_FROM_INT(shift - (int32_t)frac_bits);
+    return fx_mul(log2_value, FX_DB_PER_OCTAVE / 2);
+}
+
+/**
+ * Converte dB em potência: 10^(db/10) = 2^(db * log2(10) / 10)
+ *
+ * @param db Nível em Q15.16
+ * @return Potência inteira (0 para db < 0)
+ */
+uint64_t fx_db_to_power(fx_q16_t db)
+{
+    if (db < 0)
+    {
+        return 0;
+    }
+
+    fx_q16_t octaves = fx_mul(db, FX_OCTAVES_PER_DB);
+    int32_t exponent = octaves >> 16;
+
+    // 5 bits da fração indexam a tabela, os 11 restantes interpolam
+    uint32_t index = (octaves >> 11) & 0x1F;
+    uint32_t frac = octaves & 0x7FF;
+    uint32_t lo = exp2_mantissa_table[index];
+    uint32_t hi = exp2_mantissa_table[index + 1];
+    uint64_t mantissa = lo + (((hi - lo) * frac) >> 11);
+
+    return exponent >= 16 ? mantissa << (exponent - 16) : mantissa >> (16 - exponent);
+}
@@ -0,0 +1,215 @@
+#include "inc/level_stats.h"
+#include "inc/audio_analyzer.h"
+#include <string.h>
+
+// Duração de cada janela; o número de períodos de análise sai daqui
+static const uint32_t level_stats_durations_ms[LEVEL_STATS_WINDOW_COUNT] = {
+    60u * 1000u,       // 1 min
+    15u * 60u * 1000u, // 15 min
+    60u * 60u * 1000u, // 1 h
+};
+
+/**
+ * Acumuladores de uma janela: memória constante, qualquer que seja a duração
+ */
+typedef struct
+{
+    uint32_t histogram[LEVEL_STATS_BINS];        ///< Períodos por intervalo de 0,1 dB
+    uint64_t energy;                             ///< Soma de 10^(Leq/10) dos períodos
+    uint64_t band_energy[BAND_FILTER_MAX_BANDS]; ///< Mesma soma, por banda
+    uint8_t band_count;                          ///< Bandas acumuladas
+    uint32_t samples;                            ///< Períodos acumulados
+    uint32_t sequence;                           ///< Número da janela em andamento
+    fx_q16_t lmax;
+    fx_q16_t lmin;
+} LevelStatsAccumulator;
+
+static LevelStatsAccumulator accumulators[LEVEL_STATS_WINDOW_COUNT];
+
+// Fila de registros fechados (somente o núcleo 0 escreve e lê)
+static LevelStatsRecord records[LEVEL_STATS_RECORD_QUEUE];
+static uint32_t records_head = 0;
+static uint32_t records_tail = 0;
+static uint32_t records_dropped = 0;
+
+/**
+ * Intervalo do histograma para um nível
+ *
+ * @param level_db Nível em Q15.16
+ * @return Índice limitado a 0..LEVEL_STATS_BINS-1
+ */
+static uint32_t level_bin(fx_q16_t level_db)
+{
+    int32_t bin = (int32_t)(((int64_t)(level_db - FX_FROM_INT(LEVEL_STATS_MIN_DB)) * LEVEL_STATS_BINS_PER_DB) >> 16);
+    if (bin < 0)
+        return 0;
+    if (bin >= LEVEL_STATS_BINS)
+        return LEVEL_STATS_BINS - 1;
+    return (uint32_t)bin;
+}
+
+/**
+ * Zera uma janela, mantendo a numeração
+ */
+static void accumulator_reset(LevelStatsAccumulator *acc)
+{
+    memset(acc->histogram, 0, sizeof(acc->histogram));
+    acc->energy = 0;
+    memset(acc->band_energy, 0, sizeof(acc->band_energy));
+    acc->band_count = 0;
+    acc->samples = 0;
+    acc->lmax = INT32_MIN;
+    acc->lmin = INT32_MAX;
+}
+
+void level_stats_init(void)
+{
+    for (int i = 0; i < LEVEL_STATS_WINDOW_COUNT; i++)
+    {
+        accumulator_reset(&accumulators[i]);
+        accumulators[i].sequence = 0;
+    }
+    records_head = records_tail = 0;
+    records_dropped = 0;
+}
+
+/**
+ * Procura no histograma, de cima para baixo, o nível excedido em
+ * percent% dos períodos
+ *
+ * @param acc Janela
+ * @param percent Porcentagem (10, 50 ou 90)
+ * @return Centro do intervalo encontrado (Q15.16)
+ */
+static fx_q16_t histogram_exceeded(const LevelStatsAccumulator *acc, uint32_t percent)
+{
+    // Primeiro intervalo em que a contagem acumulada passa de percent% do total
+    uint64_t threshold = (uint64_t)acc->samples * percent;
+    uint64_t above = 0;
+    int32_t bin = LEVEL_STATS_BINS - 1;
+    for (; bin > 0; bin--)
+    {
+        above += (uint64_t)acc->histogram[bin] * 100;
+        if (above > threshold)
+        {
+            break;
+        }
+    }
+    return FX_FROM_INT(LEVEL_STATS_MIN_DB) + (fx_q16_t)(((2 * bin + 1) * (int64_t)FX_ONE) / (2 * LEVEL_STATS_BINS_PER_DB));
+}
+
+/**
+ * Monta o registro de uma janela
+ */
+static void accumulator_record(const LevelStatsAccumulator *acc, LevelStatsWindow window, LevelStatsRecord *record)
+{
+    memset(record, 0, sizeof(*record));
+    record->window = window;
+    record->sequence = acc->sequence;
+    record->samples = acc->samples;
+    if (acc->samples == 0)
+    {
+        return;
+    }
+
+    record->leq = acc->energy ? fx_power_to_db(acc->energy / acc->samples, 0) : 0;
+    record->lmax = acc->lmax;
+    record->lmin = acc->lmin;
+    record->l10 = histogram_exceeded(acc, 10);
+    record->l50 = histogram_exceeded(acc, 50);
+    record->l90 = histogram_exceeded(acc, 90);
+
+    record->band_count = acc->band_count;
+    for (int b = 0; b < acc->band_count; b++)
+    {
+        record->band_leq[b] = acc->band_energy[b] ? fx_power_to_db(acc->band_energy[b] / acc->samples, 0) : 0;
+    }
+}
+
+/**
+ * Coloca um registro fechado na fila; com a fila cheia, o registro é contado e descartado
+ */
+static void record_emit(const LevelStatsRecord *record)
+{
+    if (records_head - records_tail >= LEVEL_STATS_RECORD_QUEUE)
+    {
+        records_dropped++;
+        return;
+    }
+    records[records_head % LEVEL_STATS_RECORD_QUEUE] = *record;
+    records_head++;
+}
+
+/**
+ * Acrescenta um período de análise a todas as janelas
+ *
+ * @param level_db Nível com ponderação no tempo
+ * @param leq_db Nível equivalente do período
+ * @param bands Níveis das bandas no período (ou NULL)
+ */
+void level_stats_push(fx_q16_t level_db, fx_q16_t leq_db, const BandLevels *bands)
+{
+    uint64_t energy = fx_db_to_power(leq_db);
+    uint32_t bin = level_bin(level_db);
+
+    // A conversão para energia é feita uma vez e vale para todas as janelas
+    uint64_t band_energy[BAND_FILTER_MAX_BANDS];
+    uint8_t band_count = bands ? bands->count : 0;
+    for (int b = 0; b < band_count; b++)
+    {
+        band_energy[b] = fx_db_to_power(bands->db[b]);
+    }
+
+    for (int i = 0; i < LEVEL_STATS_WINDOW_COUNT; i++)
+    {
+        LevelStatsAccumulator *acc = &accumulators[i];
+        acc->histogram[bin]++;
+        acc->energy += energy;
+        acc->samples++;
+        for (int b = 0; b < band_count; b++)
+        {
+            acc->band_energy[b] += band_energy[b];
+        }
+        if (band_count > acc->band_count)
+            acc->band_count = band_count;
+        if (level_db > acc->lmax)
+            acc->lmax = level_db;
+        if (level_db < acc->lmin)
+            acc->lmin = level_db;
+
+        if (acc->samples * ANALYSIS_PERIOD_MS >= level_stats_durations_ms[i])
+        {
+            LevelStatsRecord record;
+            accumulator_record(acc, (LevelStatsWindow)i, &record);
+            record_emit(&record);
+            accumulator_reset(acc);
+            acc->sequence++;
+        }
+    }
+}
+
+bool level_stats_pop_record(LevelStatsRecord *record)
+{
+    if (records_head == records_tail)
+    {
+        return false;
+    }
+    *record = records[records_tail % LEVEL_STATS_RECORD_QUEUE];
+    records_tail++;
+    return true;
+}
+
+void level_stats_get_current(LevelStatsWindow window, LevelStatsRecord *record)
+{
+    accumulator_record(&accumulators[window], window, record);
+}
+
+uint32_t level_stats_get_dropped(void)
+{
+    return records_dropped;
+}
+
+uint32_t level_stats_window_ms(LevelStatsWindow window)
+{
+    return level_stats_durations_ms[window];
+}
@@ -0,0 +1,135 @@
+#include "inc/noise_floor.h"
+#include <math.h>
+#include <string.h>
+
+// Tensão máxima aceita: 16 V cabe em Q24 de V^2 com 32 bits
+#define NOISE_FLOOR_MAX_VOLTAGE FX_FROM_INT(16)
+
+/*
+ * Fator M(D) de Martin (2001) para a compensação do viés do mínimo,
+ * tabelado em função do número D de valores da janela
+ */
+static const uint16_t bias_table_d[] = {1, 2, 5, 8, 10, 15, 20, 30, 40, 60, 80, 120, 140, 160};
+static const float bias_table_m[] = {0.0f, 0.26f, 0.48f, 0.58f, 0.61f, 0.668f, 0.705f,
+                                     0.762f, 0.8f, 0.841f, 0.865f, 0.89f, 0.9f, 0.91f};
+#define BIAS_TABLE_SIZE (sizeof(bias_table_d) / sizeof(bias_table_d[0]))
+
+/**
+ * Interpola M(D) na tabela
+ *
+ * @param d Valores na janela
+ * @return M(D)
+ */
+static float bias_m(uint32_t d)
+{
+    if (d >= bias_table_d[BIAS_TABLE_SIZE - 1])
+    {
+        return bias_table_m[BIAS_TABLE_SIZE - 1];
+    }
+    uint32_t i = 1;
+    while (d > bias_table_d[i])
+    {
+        i++;
+    }
+    float t = (float)(d - bias_table_d[i - 1]) / (float)(bias_table_d[i] - bias_table_d[i - 1]);
+    return bias_table_m[i - 1] + t * (bias_table_m[i] - bias_table_m[i - 1]);
+}
+
+void noise_floor_init(NoiseFloorTracker *tracker, uint32_t period_ms, uint32_t samples_per_update)
+{
+    memset(tracker, 0, sizeof(*tracker));
+
+    uint32_t length = NOISE_FLOOR_WINDOW_MS / (NOISE_FLOOR_SUBWINDOWS * period_ms);
+    tracker->subwindow_length = length > 0 ? length : 1;
+
+    float smoothing = 1.0f - expf(-(float)period_ms / NOISE_FLOOR_SMOOTHING_MS);
+    tracker->smoothing = (int32_t)lrintf(smoothing * 65536.0f);
+
+    // Graus de liberdade da potência suavizada: a média exponencial com fator
+    // alfa equivale a (2 - alfa) / alfa atualizações independentes, e cada
+    // atualização já é a média de samples_per_update amostras
+    float averaged = (2.0f - smoothing) / smoothing;
+    float dof = (float)(samples_per_update ? samples_per_update : 1) * averaged;
+
+    // E{min} ~= média / B, com B = 1 + (D - 1) * 2 / Q~ e Q~ = (Q - M(D)) / (1 - M(D))
+    uint32_t d = tracker->subwindow_length * NOISE_FLOOR_SUBWINDOWS;
+    float m = bias_m(d);
+    float q = (dof - m) / (1.0f - m);
+    float bias = 1.0f + (float)(d - 1) * 2.0f / q;
+    tracker->bias = (int32_t)lrintf(bias * 65536.0f);
+}
+
+/**
+ * Fecha a sub-janela em andamento e recalcula o mínimo das fechadas
+ *
+ * @param tracker Estimador
+ */
+static void close_subwindow(NoiseFloorTracker *tracker)
+{
+    tracker->mins[tracker->slot] = tracker->subwindow_min;
+    tracker->slot = (tracker->slot + 1) % NOISE_FLOOR_SUBWINDOWS;
+    if (tracker->filled < NOISE_FLOOR_SUBWINDOWS)
+    {
+        tracker->filled++;
+    }
+
+    // A mais antiga saiu da janela: o mínimo é refeito sobre as que ficaram
+    uint32_t window_min = UINT32_MAX;
+    for (int i = 0; i < tracker->filled; i++)
+    {
+        if (tracker->mins[i] < window_min)
+        {
+            window_min = tracker->mins[i];
+        }
+    }
+    tracker->window_min = window_min;
+
+    tracker->subwindow_min = tracker->smoothed;
+    tracker->subwindow_count = 0;
+}
+
+fx_q16_t noise_floor_update(NoiseFloorTracker *tracker, fx_q16_t voltage)
+{
+    if (voltage < 0)
+        voltage = 0;
+    if (voltage > NOISE_FLOOR_MAX_VOLTAGE)
+        voltage = NOISE_FLOOR_MAX_VOLTAGE;
+
+    // Potência em Q24 de V^2
+    uint32_t power = (uint32_t)(((uint64_t)voltage * (uint32_t)voltage) >> 8);
+
+    if (!tracker->started)
+    {
+        tracker->smoothed = power;
+        tracker->subwindow_min = power;
+        tracker->window_min = UINT32_MAX;
+        tracker->started = true;
+    }
+    else
+    {
+        int64_t delta = (int64_t)power - tracker->smoothed;
+        tracker->smoothed = (uint32_t)((int64_t)tracker->smoothed + ((delta * tracker->smoothing) >> 16));
+    }
+
+    if (tracker->smoothed < tracker->subwindow_min)
+    {
+        tracker->subwindow_min = tracker->smoothed;
+    }
+    if (++tracker->subwindow_count >= tracker->subwindow_length)
+    {
+        close_subwindow(tracker);
+    }
+
+    uint32_t minimum = tracker->subwindow_min < tracker->window_min ? tracker->subwindow_min : tracker->window_min;
+    uint64_t noise_power = ((uint64_t)minimum * (uint32_t)tracker->bias) >> 16;
+
+    // O ruído de fundo não passa do nível atual: com um som estável o mínimo
+    // já é a própria média, e a compensação só o empurraria para cima
+    if (noise_power > tracker->smoothed)
+    {
+        noise_power = tracker->smoothed;
+    }
+
+    // sqrt de Q24 dá Q12
+    return (fx_q16_t)(fx_isqrt((uint32_t)noise_power) << 4);
+}
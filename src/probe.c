@@ -0,0 +1,119 @@
+#include "inc/probe.h"
+#include "pico/stdlib.h"
+#include "hardware/clocks.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef MIC_MONITOR_PROBES
+
+static const char *probe_names[PROBE_COUNT] = {
+    "mic_sample",
+    "bloco dsp",
+    "analyze_audio",
+    "grafico",
+    "monitor",
+    "ssd1306 sync",
+    "ssd1306 async",
+};
+
+// Tabela fixa: cada entrada só é escrita pelo núcleo que mede o ponto
+static ProbeStats probe_table[PROBE_COUNT];
+
+/**
+ * Faixa de log2 de uma duração (0 e 1 ciclo caem na faixa 0)
+ */
+static inline uint32_t probe_bucket(uint32_t cycles)
+{
+    uint32_t bucket = cycles ? 31u - (uint32_t)__builtin_clz(cycles) : 0u;
+    return bucket < PROBE_BUCKETS ? bucket : PROBE_BUCKETS - 1;
+}
+
+void probe_record(ProbeId id, uint32_t cycles)
+{
+    ProbeStats *stats = &probe_table[id];
+    if (stats->count == 0 || cycles < stats->min_cycles)
+    {
+        stats->min_cycles = cycles;
+    }
+    if (cycles > stats->max_cycles)
+    {
+        stats->max_cycles = cycles;
+    }
+    stats->total_cycles += cycles;
+    stats->buckets[probe_bucket(cycles)]++;
+    stats->count++;
+}
+
+void probe_init(void)
+{
+    cycle_counter_init();
+}
+
+void probe_get(ProbeId id, ProbeStats *stats)
+{
+    *stats = probe_table[id];
+}
+
+/**
+ * Imprime, para cada ponto, os extremos em ciclos e em microssegundos e
+ * as faixas não vazias do histograma
+ */
+void probe_dump(void)
+{
+    uint32_t cycles_per_us = clock_get_hz(clk_sys) / 1000000u;
+
+    for (int p = 0; p < PROBE_COUNT; p++)
+    {
+        ProbeStats s;
+        probe_get((ProbeId)p, &s);
+        if (s.count == 0)
+        {
+            printf("sonda %-14s sem medicoes\n", probe_names[p]);
+            continue;
+        }
+
+        uint32_t avg = (uint32_t)(s.total_cycles / s.count);
+        printf("sonda %-14s n %lu | min %lu med %lu max %lu ciclos | max %lu us\n",
+               probe_names[p], (unsigned long)s.count,
+               (unsigned long)s.min_cycles, (unsigned long)avg, (unsigned long)s.max_cycles,
+               (unsigned long)(s.max_cycles / cycles_per_us));
+
+        printf("  log2(ciclos):");
+        for (int b = 0; b < PROBE_BUCKETS; b++)
+        {
+            if (s.buckets[b])
+            {
+                printf(" %d:%lu", b, (unsigned long)s.buckets[b]);
+            }
+        }
+        printf("\n");
+    }
+}
+
+void probe_reset(void)
+{
+    memset(probe_table, 0, sizeof(probe_table));
+}
+
+#else
+
+void probe_init(void)
+{
+}
+
+void probe_get(ProbeId id, ProbeStats *stats)
+{
+    (void)id;
+    memset(stats, 0, sizeof(*stats));
+}
+
+void probe_dump(void)
+{
+    printf("sondas desligadas neste build (MIC_MONITOR_PROBES)\n");
+}
+
+void probe_reset(void)
+{
+}
+
+#endif // MIC_MONITOR_PROBES
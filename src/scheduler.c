@@ -0,0 +1,245 @@
+#include "inc/scheduler.h"
+#include "inc/event_loop.h"
+#include "pico/stdlib.h"
+#include "pico/time.h"
+#include <string.h>
+
+/**
+ * Estado de uma tarefa
+ *
+ * Os instantes são de time_us_32() e comparados pela diferença com
+ * sinal, então a volta do contador (~71 min) não atrapalha.
+ */
+typedef struct
+{
+    bool released;            ///< Liberada e ainda não executada
+    uint32_t release_us;      ///< Instante da liberação pendente
+    uint32_t next_release_us; ///< Próxima liberação periódica
+    uint32_t runs;            ///< Execuções
+    uint32_t min_us;          ///< Menor tempo de execução
+    uint32_t max_us;          ///< Maior tempo de execução
+    uint64_t total_us;        ///< Soma dos tempos, para a média
+    uint32_t max_latency_us;  ///< Maior espera entre liberação e início
+    uint32_t deadline_misses; ///< Execuções terminadas depois do prazo
+} TaskState;
+
+static const SchedulerTask *task_table = NULL;
+static TaskState task_state[SCHEDULER_MAX_TASKS];
+static uint8_t task_count = 0;
+
+// Alarme da próxima liberação periódica (0 = nenhum)
+static alarm_id_t wakeup_alarm = 0;
+static uint32_t wakeup_at_us = 0;
+
+static inline bool time_reached(uint32_t now, uint32_t at)
+{
+    return (int32_t)(now - at) >= 0;
+}
+
+void scheduler_init(const SchedulerTask *tasks, uint8_t count)
+{
+    if (count > SCHEDULER_MAX_TASKS)
+    {
+        count = SCHEDULER_MAX_TASKS;
+    }
+    memset(task_state, 0, sizeof(task_state));
+    task_table = tasks;
+    task_count = count;
+    for (int t = 0; t < count; t++)
+    {
+        task_state[t].min_us = UINT32_MAX;
+    }
+}
+
+static int64_t on_wakeup_alarm(alarm_id_t alarm, void *user_data)
+{
+    wakeup_alarm = 0;
+    event_loop_post(EVENT_LOOP_TIMER);
+    return 0;
+}
+
+/**
+ * Libera as tarefas dos eventos recebidos e as periódicas que venceram
+ *
+ * @param events Máscara de eventos entregue pelo laço
+ * @param now Instante atual
+ */
+static void release_tasks(uint32_t events, uint32_t now)
+{
+    for (int t = 0; t < task_count; t++)
+    {
+        const SchedulerTask *task = &task_table[t];
+        TaskState *state = &task_state[t];
+        uint32_t release_us = now;
+        bool due = (events & task->events) != 0;
+
+        if (task->period_ms && time_reached(now, state->next_release_us))
+        {
+            // Vale o instante em que a liberação devia ter ocorrido
+            release_us = state->next_release_us;
+            due = true;
+            state->next_release_us += task->period_ms * 1000u;
+            if (time_reached(now, state->next_release_us))
+            {
+                // Atraso maior que um período: as liberações perdidas não se acumulam
+                state->next_release_us = now + task->period_ms * 1000u;
+            }
+        }
+
+        // Uma liberação que chega com a anterior pendente se junta a ela
+        if (due && !state->released)
+        {
+            state->released = true;
+            state->release_us = release_us;
+        }
+    }
+}
+
+/**
+ * Tarefa liberada mais urgente
+ *
+ * @return Índice da tarefa, ou -1 se nenhuma está liberada
+ */
+static int next_task(void)
+{
+    int best = -1;
+    for (int t = 0; t < task_count; t++)
+    {
+        if (task_state[t].released &&
+            (best < 0 || task_table[t].priority < task_table[best].priority))
+        {
+            best = t;
+        }
+    }
+    return best;
+}
+
+static void run_task(int t)
+{
+    const SchedulerTask *task = &task_table[t];
+    TaskState *state = &task_state[t];
+    state->released = false;
+
+    uint32_t start = time_us_32();
+    task->run();
+    uint32_t end = time_us_32();
+
+    uint32_t elapsed = end - start;
+    uint32_t latency = start - state->release_us;
+    state->runs++;
+    state->total_us += elapsed;
+    if (elapsed < state->min_us)
+    {
+        state->min_us = elapsed;
+    }
+    if (elapsed > state->max_us)
+    {
+        state->max_us = elapsed;
+    }
+    if (latency > state->max_latency_us)
+    {
+        state->max_latency_us = latency;
+    }
+    if (end - state->release_us > task->deadline_ms * 1000u)
+    {
+        state->deadline_misses++;
+    }
+}
+
+/**
+ * Arma o alarme para a próxima liberação periódica
+ */
+static void arm_wakeup(uint32_t now)
+{
+    bool found = false;
+    uint32_t next = 0;
+    for (int t = 0; t < task_count; t++)
+    {
+        if (task_table[t].period_ms &&
+            (!found || (int32_t)(task_state[t].next_release_us - next) < 0))
+        {
+            next = task_state[t].next_release_us;
+            found = true;
+        }
+    }
+
+    // O alarme armado já serve
+    if (!found || (wakeup_alarm > 0 && wakeup_at_us == next))
+    {
+        return;
+    }
+    if (wakeup_alarm > 0)
+    {
+        cancel_alarm(wakeup_alarm);
+        wakeup_alarm = 0;
+    }
+
+    uint32_t delay = time_reached(now, next) ? 0 : next - now;
+    alarm_id_t alarm = add_alarm_in_us(delay, on_wakeup_alarm, NULL, true);
+    if (alarm > 0)
+    {
+        wakeup_alarm = alarm;
+        wakeup_at_us = next;
+    }
+    else
+    {
+        // Prazo já passou (ou não há alarme livre): a próxima volta confere de novo
+        event_loop_post(EVENT_LOOP_TIMER);
+    }
+}
+
+/**
+ * Laço do escalonador: dorme, libera e executa
+ */
+void scheduler_run(void)
+{
+    uint32_t now = time_us_32();
+    for (int t = 0; t < task_count; t++)
+    {
+        task_state[t].next_release_us = now;
+    }
+
+    // A primeira volta libera todas as periódicas
+    uint32_t events = 0;
+    while (1)
+    {
+        release_tasks(events, time_us_32());
+
+        // Cada tarefa roda até o fim; depois dela as periódicas vencidas entram na disputa
+        int t;
+        while ((t = next_task()) >= 0)
+        {
+            run_task(t);
+            release_tasks(0, time_us_32());
+        }
+
+        arm_wakeup(time_us_32());
+        events = event_loop_wait();
+    }
+}
+
+uint8_t scheduler_get_task_count(void)
+{
+    return task_count;
+}
+
+const SchedulerTask *scheduler_get_task(uint8_t task)
+{
+    return task < task_count ? &task_table[task] : NULL;
+}
+
+bool scheduler_get_stats(uint8_t task, SchedulerTaskStats *stats)
+{
+    if (task >= task_count)
+    {
+        return false;
+    }
+    const TaskState *state = &task_state[task];
+    stats->runs = state->runs;
+    stats->min_us = state->runs ? state->min_us : 0;
+    stats->avg_us = state->runs ? (uint32_t)(state->total_us / state->runs) : 0;
+    stats->max_us = state->max_us;
+    stats->max_latency_us = state->max_latency_us;
+    stats->deadline_misses = state->deadline_misses;
+    return true;
+}
@@ -0,0 +1,299 @@
+#include "inc/sound_level.h"
+#include "inc/audio_analyzer.h"
+#include "drivers/mic/mic.h"
+#include <math.h>
+#include <string.h>
+
+/*
+ * As curvas A e C são montadas a partir dos polos analógicos da IEC 61672,
+ * cada um virando uma seção de 1ª ordem pela transformação bilinear
+ * (com pré-distorção na frequência do polo):
+ *   C = 2 passa-altas em 20,6 Hz e 2 passa-baixas em 12194 Hz
+ *   A = C seguida de passa-altas em 107,7 Hz e 737,9 Hz
+ * Os polos dos passa-altas ficam muito perto de 1, então essas seções
+ * guardam k = 1 - p, e não p, para manter a precisão em 32 bits.
+ */
+#define SOUND_HP_20_HZ 20.598997f
+#define SOUND_HP_107_HZ 107.65265f
+#define SOUND_HP_737_HZ 737.86223f
+#define SOUND_LP_12K_HZ 12194.217f
+#define SOUND_PI 3.14159265f
+
+// Entrada em Q1 de códigos do ADC: +-4096, com folga para os transitórios da cascata
+#define SOUND_INPUT_SHIFT 1
+#define SOUND_ADC_MIDSCALE ((MIC_ADC_MAX + 1) / 2)
+
+// Coeficientes dos passa-altas em Q18 e dos passa-baixas em Q14
+#define SOUND_HP_SHIFT 18
+#define SOUND_LP_SHIFT 14
+
+// Potência dos integradores em Q16 de (códigos Q1)^2
+#define SOUND_POWER_FRAC 16
+// Limite da potência média por trecho, para o produto com alfa caber em 64 bits
+#define SOUND_POWER_MAX (1ull << 31)
+
+// Piso do nível exibido, o mesmo de estimated_db
+#define SOUND_DB_MIN FX_FROM_FLOAT(25.0)
+
+/**
+ * Passa-altas de 1ª ordem: y = (1 - k) * y1 + (1 - k/2) * (x - x1)
+ * O resto do deslocamento volta na amostra seguinte (realimentação do erro),
+ * então a seção não fica presa em um nível DC por arredondamento
+ */
+typedef struct
+{
+    int32_t k;   ///< 1 - p em Q18
+    int32_t x1;  ///< Entrada anterior
+    int32_t y1;  ///< Saída anterior
+    int32_t err; ///< Resto do último deslocamento
+} SoundHighPass;
+
+/**
+ * Passa-baixas de 1ª ordem: y = g * (x + x1) + p * y1
+ */
+typedef struct
+{
+    int32_t g;  ///< Ganho em Q14
+    int32_t p;  ///< Polo em Q14
+    int32_t x1; ///< Entrada anterior
+    int32_t y1; ///< Saída anterior
+} SoundLowPass;
+
+static SoundHighPass hp_20[2];
+static SoundLowPass lp_12k[2];
+static SoundHighPass hp_107;
+static SoundHighPass hp_737;
+
+// Acumuladores do trecho em andamento (quadrados das saídas filtradas)
+static uint64_t sum_sq[SOUND_WEIGHTING_COUNT];
+static uint32_t sum_count = 0;
+
+// Integradores exponenciais: potência média em Q16
+static uint64_t power[SOUND_WEIGHTING_COUNT][SOUND_TIME_COUNT];
+
+// Energia dos trechos desde a última leitura, para o nível equivalente
+static uint64_t period_energy[SOUND_WEIGHTING_COUNT];
+static uint32_t period_chunks = 0;
+
+// Fator de cada integrador por trecho de SAMPLES amostras (Q16)
+static int32_t alpha[SOUND_TIME_COUNT];
+static int32_t alpha_impulse_decay;
+
+// Conversão de 10*log10(potência) para a escala de estimated_db, por curva
+static fx_q16_t db_offset[SOUND_WEIGHTING_COUNT];
+
+/**
+ * Pré-distorção da bilinear: K = tan(pi * f / fs)
+ */
+static float prewarp(float frequency)
+{
+    return tanf(SOUND_PI * frequency / MIC_SAMPLE_RATE_HZ);
+}
+
+static void high_pass_init(SoundHighPass *section, float frequency)
+{
+    float k = prewarp(frequency);
+    memset(section, 0, sizeof(*section));
+    section->k = (int32_t)lrintf(2.0f * k / (1.0f + k) * (1 << SOUND_HP_SHIFT));
+}
+
+static void low_pass_init(SoundLowPass *section, float frequency)
+{
+    float k = prewarp(frequency);
+    memset(section, 0, sizeof(*section));
+    section->g = (int32_t)lrintf(k / (1.0f + k) * (1 << SOUND_LP_SHIFT));
+    section->p = (int32_t)lrintf((1.0f - k) / (1.0f + k) * (1 << SOUND_LP_SHIFT));
+}
+
+/**
+ * Módulo das seções em uma frequência, para normalizar as curvas em 1 kHz
+ */
+static float high_pass_gain(float cutoff, float frequency)
+{
+    float k = prewarp(cutoff);
+    float p = (1.0f - k) / (1.0f + k);
+    float w = 2.0f * SOUND_PI * frequency / MIC_SAMPLE_RATE_HZ;
+    return (1.0f + p) / 2.0f * 2.0f * fabsf(sinf(w / 2.0f)) / sqrtf(1.0f - 2.0f * p * cosf(w) + p * p);
+}
+
+static float low_pass_gain(float cutoff, float frequency)
+{
+    float k = prewarp(cutoff);
+    float p = (1.0f - k) / (1.0f + k);
+    float w = 2.0f * SOUND_PI * frequency / MIC_SAMPLE_RATE_HZ;
+    return k / (1.0f + k) * 2.0f * fabsf(cosf(w / 2.0f)) / sqrtf(1.0f - 2.0f * p * cosf(w) + p * p);
+}
+
+/**
+ * Fator de um integrador exponencial avançando SAMPLES amostras de uma vez
+ */
+static int32_t integrator_alpha(float time_constant_s)
+{
+    float blocks_per_tau = time_constant_s * MIC_SAMPLE_RATE_HZ / SAMPLES;
+    return (int32_t)lrintf((1.0f - expf(-1.0f / blocks_per_tau)) * 65536.0f);
+}
+
+/**
+ * Calcula os coeficientes dos filtros e zera o estado
+ * Executada uma vez, então o uso de float é pontual
+ */
+void sound_level_init(void)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        high_pass_init(&hp_20[i], SOUND_HP_20_HZ);
+        low_pass_init(&lp_12k[i], SOUND_LP_12K_HZ);
+    }
+    high_pass_init(&hp_107, SOUND_HP_107_HZ);
+    high_pass_init(&hp_737, SOUND_HP_737_HZ);
+
+    alpha[SOUND_TIME_FAST] = integrator_alpha(0.125f);
+    alpha[SOUND_TIME_SLOW] = integrator_alpha(1.0f);
+    alpha[SOUND_TIME_IMPULSE] = integrator_alpha(0.035f);
+    alpha_impulse_decay = integrator_alpha(1.5f);
+
+    // 20*log10(V) + 100 com V = sqrt(potência) / 2 * 3,3 V / 4096 * ganho
+    float calibration = 20.0f * log10f(3.3f * MIC_GAIN_FACTOR / (4096.0f * (1 << SOUND_INPUT_SHIFT))) + 100.0f;
+    float c_gain = high_pass_gain(SOUND_HP_20_HZ, 1000.0f) * high_pass_gain(SOUND_HP_20_HZ, 1000.0f) *
+                   low_pass_gain(SOUND_LP_12K_HZ, 1000.0f) * low_pass_gain(SOUND_LP_12K_HZ, 1000.0f);
+    float a_gain = c_gain * high_pass_gain(SOUND_HP_107_HZ, 1000.0f) * high_pass_gain(SOUND_HP_737_HZ, 1000.0f);
+    db_offset[SOUND_WEIGHTING_A] = (fx_q16_t)lrintf((calibration - 20.0f * log10f(a_gain)) * 65536.0f);
+    db_offset[SOUND_WEIGHTING_C] = (fx_q16_t)lrintf((calibration - 20.0f * log10f(c_gain)) * 65536.0f);
+
+    memset(sum_sq, 0, sizeof(sum_sq));
+    memset(power, 0, sizeof(power));
+    memset(period_energy, 0, sizeof(period_energy));
+    sum_count = 0;
+    period_chunks = 0;
+}
+
+static inline int32_t high_pass(SoundHighPass *s, int32_t x)
+{
+    int32_t d = x - s->x1;
+    int32_t acc = s->k * (2 * s->y1 + d) + s->err;
+    int32_t y = s->y1 + d - (acc >> (SOUND_HP_SHIFT + 1));
+    s->err = acc & ((1 << (SOUND_HP_SHIFT + 1)) - 1);
+    s->x1 = x;
+    s->y1 = y;
+    return y;
+}
+
+static inline int32_t low_pass(SoundLowPass *s, int32_t x)
+{
+    int32_t y = (s->g * (x + s->x1) + s->p * s->y1 + (1 << (SOUND_LP_SHIFT - 1))) >> SOUND_LP_SHIFT;
+    s->x1 = x;
+    s->y1 = y;
+    return y;
+}
+
+/**
+ * Avança os integradores com a potência média do trecho acumulado
+ */
+static void integrate(void)
+{
+    for (int w = 0; w < SOUND_WEIGHTING_COUNT; w++)
+    {
+        uint64_t mean = sum_sq[w] / sum_count;
+        if (mean > SOUND_POWER_MAX)
+        {
+            mean = SOUND_POWER_MAX;
+        }
+        int64_t target = (int64_t)(mean << SOUND_POWER_FRAC);
+        period_energy[w] += mean;
+
+        for (int t = 0; t < SOUND_TIME_COUNT; t++)
+        {
+            int64_t current = (int64_t)power[w][t];
+            int32_t a = alpha[t];
+            if (t == SOUND_TIME_IMPULSE && target < current)
+            {
+                a = alpha_impulse_decay;
+            }
+            power[w][t] = (uint64_t)(current + (((target - current) * a) >> 16));
+        }
+        sum_sq[w] = 0;
+    }
+    sum_count = 0;
+    period_chunks++;
+}
+
+/**
+ * Passa um bloco pelas cascatas C e A e acumula os quadrados
+ *
+ * @param samples Amostras de 12 bits do ADC
+ * @param count Número de amostras
+ */
+void sound_level_process(const uint16_t *samples, uint32_t count)
+{
+    while (count)
+    {
+        uint32_t chunk = SAMPLES - sum_count;
+        if (chunk > count)
+        {
+            chunk = count;
+        }
+        count -= chunk;
+        sum_count += chunk;
+
+        uint64_t sq_a = sum_sq[SOUND_WEIGHTING_A];
+        uint64_t sq_c = sum_sq[SOUND_WEIGHTING_C];
+        while (chunk--)
+        {
+            int32_t x = ((int32_t)*samples++ - SOUND_ADC_MIDSCALE) << SOUND_INPUT_SHIFT;
+            int32_t c = low_pass(&lp_12k[1], low_pass(&lp_12k[0], high_pass(&hp_20[1], high_pass(&hp_20[0], x))));
+            int32_t a = high_pass(&hp_737, high_pass(&hp_107, c));
+            // |c| e |a| ficam abaixo de 2^16, então os quadrados cabem em 32 bits sem sinal
+            uint32_t mc = (uint32_t)(c < 0 ? -c : c);
+            uint32_t ma = (uint32_t)(a < 0 ? -a : a);
+            sq_c += mc * mc;
+            sq_a += ma * ma;
+        }
+        sum_sq[SOUND_WEIGHTING_A] = sq_a;
+        sum_sq[SOUND_WEIGHTING_C] = sq_c;
+
+        if (sum_count == SAMPLES)
+        {
+            integrate();
+        }
+    }
+}
+
+/**
+ * Converte uma potência em Q16 para dB na escala de estimated_db
+ *
+ * @param value Potência em Q16
+ * @param weighting Curva que produziu a potência
+ * @return Nível em dB (Q15.16), com piso em SOUND_DB_MIN
+ */
+static fx_q16_t power_to_level(uint64_t value, int weighting)
+{
+    if (value == 0)
+    {
+        return SOUND_DB_MIN;
+    }
+    fx_q16_t db = fx_power_to_db(value, SOUND_POWER_FRAC) + db_offset[weighting];
+    return db < SOUND_DB_MIN ? SOUND_DB_MIN : db;
+}
+
+/**
+ * Converte os integradores em dB na escala de estimated_db e fecha o
+ * período do nível equivalente
+ *
+ * @param levels Estrutura de saída
+ */
+void sound_level_get(SoundLevels *levels)
+{
+    for (int w = 0; w < SOUND_WEIGHTING_COUNT; w++)
+    {
+        for (int t = 0; t < SOUND_TIME_COUNT; t++)
+        {
+            levels->db[w][t] = power_to_level(power[w][t], w);
+        }
+
+        // Sem trecho completo desde a última leitura, o equivalente é o próprio Fast
+        levels->leq_db[w] = period_chunks ? power_to_level((period_energy[w] / period_chunks) << SOUND_POWER_FRAC, w)
+                                          : levels->db[w][SOUND_TIME_FAST];
+        period_energy[w] = 0;
+    }
+    period_chunks = 0;
+}
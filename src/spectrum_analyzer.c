@@ -0,0 +1,343 @@
+#include "inc/spectrum_analyzer.h"
+#include "inc/fixed_point.h"
+#include "inc/cycle_counter.h"
+#include "drivers/mic/mic.h"
+#include "hardware/clocks.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+// sin(2*pi*k/1024) em Q15, k = 0..256 (um quarto de onda).
+// Cobre todas as FFTs suportadas: o twiddle de uma FFT de n pontos
+// é a entrada k * (1024 / n).
+#define TWIDDLE_TABLE_SIZE 1024
+static const int16_t sine_table[TWIDDLE_TABLE_SIZE / 4 + 1] = {
+    0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809, 2009, 2210,
+    2411, 2611, 2811, 3012, 3212, 3412, 3612, 3812, 4011, 4211, 4410, 4609,
+    4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195, 6393, 6590, 6787, 6983,
+    7180, 7376, 7571, 7767, 7962, 8157, 8351, 8546, 8740, 8933, 9127, 9319,
+    9512, 9704, 9896, 10088, 10279, 10469, 10660, 10850, 11039, 11228, 11417, 11605,
+    11793, 11980, 12167, 12354, 12540, 12725, 12910, 13095, 13279, 13463, 13646, 13828,
+    14010, 14192, 14373, 14553, 14733, 14912, 15091, 15269, 15447, 15624, 15800, 15976,
+    16151, 16326, 16500, 16673, 16846, 17018, 17190, 17361, 17531, 17700, 17869, 18037,
+    18205, 18372, 18538, 18703, 18868, 19032, 19195, 19358, 19520, 19681, 19841, 20001,
+    20160, 20318, 20475, 20632, 20788, 20943, 21097, 21251, 21403, 21555, 21706, 21856,
+    22006, 22154, 22302, 22449, 22595, 22740, 22884, 23028, 23170, 23312, 23453, 23593,
+    23732, 23870, 24008, 24144, 24279, 24414, 24548, 24680, 24812, 24943, 25073, 25202,
+    25330, 25457, 25583, 25708, 25833, 25956, 26078, 26199, 26320, 26439, 26557, 26674,
+    26791, 26906, 27020, 27133, 27246, 27357, 27467, 27576, 27684, 27791, 27897, 28002,
+    28106, 28209, 28311, 28411, 28511, 28610, 28707, 28803, 28899, 28993, 29086, 29178,
+    29269, 29359, 29448, 29535, 29622, 29707, 29792, 29875, 29957, 30038, 30118, 30196,
+    30274, 30350, 30425, 30499, 30572, 30644, 30715, 30784, 30853, 30920, 30986, 31050,
+    31114, 31177, 31238, 31298, 31357, 31415, 31471, 31527, 31581, 31634, 31686, 31737,
+    31786, 31834, 31881, 31927, 31972, 32015, 32058, 32099, 32138, 32177, 32214, 32251,
+    32286, 32319, 32352, 32383, 32413, 32442, 32470, 32496, 32522, 32546, 32568, 32590,
+    32610, 32629, 32647, 32664, 32679, 32693, 32706, 32718, 32729, 32738, 32746, 32753,
+    32758, 32762, 32766, 32767, 32767,
+};
+
+// Estado do analisador
+static uint16_t fft_size = SPECTRUM_FFT_SIZE;
+static int16_t window[SPECTRUM_MAX_FFT_SIZE];                      // Janela de Hann em Q15
+static int16_t work[SPECTRUM_MAX_FFT_SIZE] __attribute__((aligned(4))); // Quadro janelado / FFT in-place
+
+// Magnitudes em buffer duplo: o display (núcleo 0) lê o buffer publicado
+// enquanto a FFT (núcleo 1) escreve no outro
+static uint16_t magnitudes[2][SPECTRUM_MAX_FFT_SIZE / 2];
+static volatile uint8_t published = 0;
+
+// Montagem de quadros a partir dos blocos da captura (buffer duplo)
+static uint16_t frame_buffers[2][SPECTRUM_MAX_FFT_SIZE];
+static uint8_t fill_buffer = 0;
+static uint32_t fill_count = 0;
+static volatile bool frame_ready = false;
+
+static SpectrumStats stats;
+
+/**
+ * Lê sin e cos de 2*pi*j/1024 na tabela de um quarto de onda
+ *
+ * @param j Índice do ângulo, de 0 a 512
+ * @param c Saída com o cosseno em Q15
+ * @param s Saída com o seno em Q15
+ */
+static inline void twiddle(uint32_t j, int32_t *c, int32_t *s)
+{
+    if (j <= TWIDDLE_TABLE_SIZE / 4)
+    {
+        *s = sine_table[j];
+        *c = sine_table[TWIDDLE_TABLE_SIZE / 4 - j];
+    }
+    else
+    {
+        *s = sine_table[TWIDDLE_TABLE_SIZE / 2 - j];
+        *c = -sine_table[j - TWIDDLE_TABLE_SIZE / 4];
+    }
+}
+
+/**
+ * Inicializa o analisador para um tamanho de FFT
+ *
+ * @param size Tamanho da FFT (256, 512 ou 1024)
+ * @return true se o tamanho é suportado
+ */
+bool spectrum_init(uint16_t size)
+{
+    if (size != 256 && size != 512 && size != 1024)
+    {
+        return false;
+    }
+    fft_size = size;
+
+    // Hann: w[n] = (1 - cos(2*pi*n/N)) / 2, simétrica em torno de N/2
+    uint32_t stride = TWIDDLE_TABLE_SIZE / size;
+    for (uint32_t n = 0; n <= size / 2; n++)
+    {
+        int32_t c, s;
+        twiddle(n * stride, &c, &s);
+        window[n] = (int16_t)((32767 - c) >> 1);
+        if (n > 0)
+        {
+            window[size - n] = window[n];
+        }
+    }
+
+    memset(magnitudes, 0, sizeof(magnitudes));
+    memset(&stats, 0, sizeof(stats));
+    fill_count = 0;
+    frame_ready = false;
+
+    // Ciclos disponíveis = tempo para o ADC encher um quadro
+    cycle_counter_init();
+    stats.budget_cycles = (uint32_t)(((uint64_t)clock_get_hz(clk_sys) * size) / (uint32_t)MIC_SAMPLE_RATE_HZ);
+
+    return true;
+}
+
+/**
+ * Copia amostras da captura para o quadro em montagem
+ *
+ * @param samples Amostras do ADC
+ * @param count Número de amostras
+ */
+void spectrum_push_samples(const uint16_t *samples, uint32_t count)
+{
+    while (count)
+    {
+        uint32_t space = fft_size - fill_count;
+        uint32_t chunk = count < space ? count : space;
+
+        memcpy(&frame_buffers[fill_buffer][fill_count], samples, chunk * sizeof(uint16_t));
+        fill_count += chunk;
+        samples += chunk;
+        count -= chunk;
+
+        if (fill_count == fft_size)
+        {
+            if (frame_ready)
+            {
+                // O quadro anterior ainda não foi processado: reaproveita o buffer
+                stats.dropped++;
+            }
+            else
+            {
+                fill_buffer ^= 1;
+                frame_ready = true;
+            }
+            fill_count = 0;
+        }
+    }
+}
+
+/**
+ * FFT complexa radix-2 in-place (decimação no tempo), em Q15
+ *
+ * Cada estágio divide o resultado por 2, então a magnitude complexa
+ * nunca cresce e não há saturação.
+ *
+ * @param data Pares (real, imaginário) intercalados
+ * @param m Número de pontos complexos (potência de 2)
+ */
+static void fft_complex(int16_t *data, uint32_t m)
+{
+    uint32_t *points = (uint32_t *)data;
+
+    // Reordena os pontos pela ordem de bits invertida
+    for (uint32_t i = 1, j = 0; i < m; i++)
+    {
+        uint32_t bit = m >> 1;
+        for (; j & bit; bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j)
+        {
+            uint32_t tmp = points[i];
+            points[i] = points[j];
+            points[j] = tmp;
+        }
+    }
+
+    // Borboletas: o laço externo em k reaproveita o mesmo twiddle
+    for (uint32_t len = 2; len <= m; len <<= 1)
+    {
+        uint32_t half = len >> 1;
+        uint32_t stride = TWIDDLE_TABLE_SIZE / len;
+
+        for (uint32_t k = 0; k < half; k++)
+        {
+            int32_t wr, ws;
+            twiddle(k * stride, &wr, &ws); // W = wr - i*ws
+
+            for (uint32_t i = k; i < m; i += len)
+            {
+                int16_t *a = &data[2 * i];
+                int16_t *b = &data[2 * (i + half)];
+                int32_t tr = (b[0] * wr + b[1] * ws) >> 15;
+                int32_t ti = (b[1] * wr - b[0] * ws) >> 15;
+                int32_t ar = a[0];
+                int32_t ai = a[1];
+
+                a[0] = (int16_t)((ar + tr) >> 1);
+                a[1] = (int16_t)((ai + ti) >> 1);
+                b[0] = (int16_t)((ar - tr) >> 1);
+                b[1] = (int16_t)((ai - ti) >> 1);
+            }
+        }
+    }
+}
+
+/**
+ * Magnitude de um número complexo com inteiros de 32 bits
+ *
+ * @param re Parte real
+ * @param im Parte imaginária
+ * @return Magnitude limitada a 16 bits
+ */
+static uint16_t complex_magnitude(int32_t re, int32_t im)
+{
+    uint32_t ar = re < 0 ? -re : re;
+    uint32_t ai = im < 0 ? -im : im;
+    uint32_t mag;
+
+    if ((ar | ai) > 0x7FFF)
+    {
+        // Evita estouro da soma dos quadrados em 32 bits
+        ar >>= 1;
+        ai >>= 1;
+        mag = fx_isqrt(ar * ar + ai * ai) << 1;
+    }
+    else
+    {
+        mag = fx_isqrt(ar * ar + ai * ai);
+    }
+    return mag > 0xFFFF ? 0xFFFF : (uint16_t)mag;
+}
+
+/**
+ * FFT real de N pontos via FFT complexa de N/2 pontos
+ *
+ * As amostras pares/ímpares são tratadas como parte real/imaginária
+ * (o próprio vetor intercalado), e o espectro real é separado depois.
+ *
+ * @param frame Quadro em Q15 (destruído)
+ * @param out Saída com N/2 magnitudes
+ */
+void spectrum_compute(int16_t *frame, uint16_t *out)
+{
+    uint32_t m = fft_size >> 1;
+    uint32_t stride = TWIDDLE_TABLE_SIZE / fft_size;
+
+    fft_complex(frame, m);
+
+    // X[k] = E[k] - i*W^k*O[k], com E = (Z[k] + Z*[m-k]) / 2 e O = (Z[k] - Z*[m-k]) / 2
+    for (uint32_t k = 0; k < m; k++)
+    {
+        uint32_t mk = k ? m - k : 0;
+        int32_t zr = frame[2 * k];
+        int32_t zi = frame[2 * k + 1];
+        int32_t cr = frame[2 * mk];
+        int32_t ci = frame[2 * mk + 1];
+
+        int32_t er = (zr + cr) >> 1;
+        int32_t ei = (zi - ci) >> 1;
+        int32_t or_ = (zr - cr) >> 1;
+        int32_t oi = (zi + ci) >> 1;
+
+        int32_t c, s;
+        twiddle(k * stride, &c, &s);
+
+        int32_t xr = er + ((c * oi - s * or_) >> 15);
+        int32_t xi = ei - ((c * or_ + s * oi) >> 15);
+
+        out[k] = complex_magnitude(xr, xi);
+    }
+}
+
+/**
+ * Processa o quadro pendente, se houver
+ *
+ * @return true se um novo espectro foi calculado
+ */
+bool spectrum_process(void)
+{
+    if (!frame_ready)
+    {
+        return false;
+    }
+
+    uint32_t start = cycle_counter_now();
+    const uint16_t *raw = frame_buffers[fill_buffer ^ 1];
+
+    // Remove o nível DC do quadro
+    uint32_t sum = 0;
+    for (uint32_t n = 0; n < fft_size; n++)
+    {
+        sum += raw[n];
+    }
+    int32_t mean = sum / fft_size;
+
+    // Amostras de 12 bits com 2 bits extras de escala, janeladas em Q15
+    for (uint32_t n = 0; n < fft_size; n++)
+    {
+        work[n] = (int16_t)((((int32_t)raw[n] - mean) * 4 * window[n]) >> 15);
+    }
+
+    // O quadro bruto já foi consumido; a captura pode reutilizar o buffer
+    frame_ready = false;
+
+    spectrum_compute(work, magnitudes[published ^ 1]);
+
+    // Publica o novo espectro só depois de completo
+    __dmb();
+    published ^= 1;
+
+    stats.last_cycles = cycle_counter_elapsed(start);
+    if (stats.last_cycles > stats.max_cycles)
+    {
+        stats.max_cycles = stats.last_cycles;
+    }
+    stats.frames++;
+
+    return true;
+}
+
+const uint16_t *spectrum_get_magnitudes(void)
+{
+    return magnitudes[published];
+}
+
+uint16_t spectrum_get_bin_count(void)
+{
+    return fft_size >> 1;
+}
+
+uint32_t spectrum_bin_frequency(uint16_t bin)
+{
+    return (uint32_t)(bin * (uint32_t)MIC_SAMPLE_RATE_HZ) / fft_size;
+}
+
+void spectrum_get_stats(SpectrumStats *out)
+{
+    *out = stats;
+}
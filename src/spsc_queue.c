@@ -0,0 +1,72 @@
+#include "inc/spsc_queue.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+/**
+ * Inicializa a fila sobre o buffer fornecido
+ *
+ * @param queue Fila a inicializar
+ * @param buffer Área de armazenamento
+ * @param element_size Tamanho de cada elemento em bytes
+ * @param capacity Número de posições (potência de 2)
+ */
+void spsc_queue_init(SpscQueue *queue, void *buffer, uint16_t element_size, uint16_t capacity)
+{
+    queue->buffer = buffer;
+    queue->element_size = element_size;
+    queue->capacity = capacity;
+    queue->head = 0;
+    queue->tail = 0;
+    queue->dropped = 0;
+}
+
+/**
+ * Copia um elemento para a fila
+ *
+ * @param queue Fila
+ * @param element Elemento a inserir
+ * @return true se o elemento foi inserido
+ */
+bool spsc_queue_push(SpscQueue *queue, const void *element)
+{
+    uint32_t head = queue->head;
+
+    if (head - queue->tail >= queue->capacity)
+    {
+        queue->dropped++;
+        return false;
+    }
+
+    memcpy(&queue->buffer[(head & (queue->capacity - 1)) * queue->element_size], element, queue->element_size);
+
+    // O conteúdo precisa estar visível para o outro núcleo antes do novo head
+    __dmb();
+    queue->head = head + 1;
+    return true;
+}
+
+/**
+ * Copia o elemento mais antigo da fila
+ *
+ * @param queue Fila
+ * @param element Destino
+ * @return true se havia elemento
+ */
+bool spsc_queue_pop(SpscQueue *queue, void *element)
+{
+    uint32_t tail = queue->tail;
+
+    if (queue->head == tail)
+    {
+        return false;
+    }
+
+    // Lê o conteúdo só depois de observar o head atualizado
+    __dmb();
+    memcpy(element, &queue->buffer[(tail & (queue->capacity - 1)) * queue->element_size], queue->element_size);
+
+    // A posição só é liberada depois que a cópia terminou
+    __dmb();
+    queue->tail = tail + 1;
+    return true;
+}
@@ -0,0 +1,219 @@
+#include "inc/tone_detector.h"
+#include "inc/spsc_queue.h"
+#include <math.h>
+#include <string.h>
+
+#define TONE_PI 3.14159265f
+
+// Coeficientes em Q14
+#define TONE_COEF_SHIFT 14
+
+// O estado do Goertzel chega a ~2^26 nas frequências graves; a multiplicação
+// pelo coeficiente é feita em duas metades (s = alto * 2^10 + baixo) para
+// caber em 32 bits, que o M0+ multiplica em um ciclo
+#define TONE_SPLIT_SHIFT 10
+#define TONE_SPLIT_MASK ((1 << TONE_SPLIT_SHIFT) - 1)
+
+/**
+ * Estado de um detector
+ */
+typedef struct
+{
+    int32_t coeff;        ///< 2 * cos(w) em Q14
+    int32_t cosine;       ///< cos(w) em Q14
+    int32_t sine;         ///< sin(w) em Q14
+    uint32_t min_samples; ///< min_duration_ms em amostras
+    uint32_t run_samples; ///< Amostras seguidas acima de on_share; depois de confirmado, duração do tom
+    bool active;          ///< Tom confirmado
+} ToneDetector;
+
+static const ToneDetectorConfig *tone_configs = NULL;
+static ToneDetector detectors[TONE_DETECTOR_MAX];
+static uint8_t detector_count = 0;
+static uint32_t sample_rate = 0;
+
+// Bloco sem o DC, compartilhado por todos os detectores
+static int16_t tone_buffer[SAMPLES];
+
+// Eventos: produtor no núcleo de DSP, consumidor no núcleo de interface
+static ToneEvent event_storage[TONE_EVENT_QUEUE_SIZE];
+static SpscQueue event_queue;
+
+void tone_detector_init(const ToneDetectorConfig *configs, uint8_t count)
+{
+    if (count > TONE_DETECTOR_MAX)
+    {
+        count = TONE_DETECTOR_MAX;
+    }
+
+    memset(detectors, 0, sizeof(detectors));
+    tone_configs = configs;
+    detector_count = count;
+    sample_rate = (uint32_t)MIC_SAMPLE_RATE_HZ;
+
+    for (int d = 0; d < count; d++)
+    {
+        float w = 2.0f * TONE_PI * (float)configs[d].frequency_hz / MIC_SAMPLE_RATE_HZ;
+        detectors[d].coeff = (int32_t)lrintf(2.0f * cosf(w) * (1 << TONE_COEF_SHIFT));
+        detectors[d].cosine = (int32_t)lrintf(cosf(w) * (1 << TONE_COEF_SHIFT));
+        detectors[d].sine = (int32_t)lrintf(sinf(w) * (1 << TONE_COEF_SHIFT));
+        detectors[d].min_samples = (uint32_t)configs[d].min_duration_ms * sample_rate / 1000u;
+    }
+
+    spsc_queue_init(&event_queue, event_storage, sizeof(ToneEvent), TONE_EVENT_QUEUE_SIZE);
+}
+
+void tone_detector_reset(void)
+{
+    tone_detector_init(tone_configs, detector_count);
+}
+
+/**
+ * coeff * s >> 14 sem passar de 32 bits
+ */
+static inline int32_t goertzel_mul(int32_t coeff, int32_t s)
+{
+    int32_t high = coeff * (s >> TONE_SPLIT_SHIFT);
+    int32_t low = (coeff * (s & TONE_SPLIT_MASK)) >> TONE_SPLIT_SHIFT;
+    return (high + low) >> (TONE_COEF_SHIFT - TONE_SPLIT_SHIFT);
+}
+
+/**
+ * Goertzel sobre o bloco: |X(w)|^2
+ *
+ * @param detector Detector
+ * @param count Amostras em tone_buffer
+ * @return Potência na frequência do detector
+ */
+static uint64_t goertzel_power(const ToneDetector *detector, uint32_t count)
+{
+    const int32_t coeff = detector->coeff;
+    int32_t s1 = 0;
+    int32_t s2 = 0;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        int32_t s0 = tone_buffer[i] + goertzel_mul(coeff, s1) - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+
+    // X = s1 - s2 * e^(-jw)
+    int64_t re = (int64_t)s1 - (((int64_t)s2 * detector->cosine) >> TONE_COEF_SHIFT);
+    int64_t im = ((int64_t)s2 * detector->sine) >> TONE_COEF_SHIFT;
+    return (uint64_t)(re * re) + (uint64_t)(im * im);
+}
+
+/**
+ * Fração da potência AC do bloco que está no tom: 2 * |X|^2 / (N^2 * P)
+ * (1 para um tom puro na frequência do detector)
+ */
+static fx_q16_t tone_share(uint64_t power, uint32_t count, uint32_t ac_power)
+{
+    uint64_t num = power * 2;
+    uint64_t den = (uint64_t)count * count * ac_power;
+
+    // Reduz os dois lados até o deslocamento de 16 bits caber em 64 bits
+    while (num >= (1ull << 47))
+    {
+        num >>= 1;
+        den >>= 1;
+    }
+    if (den == 0)
+    {
+        return 0;
+    }
+    uint64_t share = (num << 16) / den;
+    return share > FX_ONE ? FX_ONE : (fx_q16_t)share;
+}
+
+static void emit(uint8_t index, bool active, uint32_t samples, fx_q16_t share)
+{
+    ToneEvent event = {
+        .detector = index,
+        .active = active,
+        .duration_ms = (uint32_t)(((uint64_t)samples * 1000u) / sample_rate),
+        .share = share,
+    };
+    spsc_queue_push(&event_queue, &event);
+}
+
+/**
+ * Aplica a histerese e a duração mínima de um detector ao bloco
+ */
+static void update_state(uint8_t index, fx_q16_t share, uint32_t count)
+{
+    const ToneDetectorConfig *config = &tone_configs[index];
+    ToneDetector *detector = &detectors[index];
+
+    if (!detector->active)
+    {
+        if (share < config->on_share)
+        {
+            detector->run_samples = 0;
+            return;
+        }
+        detector->run_samples += count;
+        if (detector->run_samples >= detector->min_samples)
+        {
+            detector->active = true;
+            emit(index, true, detector->run_samples, share);
+        }
+        return;
+    }
+
+    if (share < config->off_share)
+    {
+        detector->active = false;
+        emit(index, false, detector->run_samples, share);
+        detector->run_samples = 0;
+        return;
+    }
+    detector->run_samples += count;
+}
+
+/**
+ * Passa um bloco por todos os detectores
+ *
+ * @param samples Amostras de 12 bits do ADC
+ * @param stats Estatísticas do mesmo bloco
+ */
+void tone_detector_process(const uint16_t *samples, const MicBlockStats *stats)
+{
+    uint32_t count = stats->count > SAMPLES ? SAMPLES : stats->count;
+    if (detector_count == 0 || count == 0)
+    {
+        return;
+    }
+
+    // Silêncio: nenhum detector vê tom, mas o estado avança do mesmo jeito
+    bool quiet = stats->ac_power < TONE_MIN_BLOCK_POWER;
+    if (!quiet)
+    {
+        int32_t dc = stats->dc_mean;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            tone_buffer[i] = (int16_t)((int32_t)samples[i] - dc);
+        }
+    }
+
+    for (uint8_t d = 0; d < detector_count; d++)
+    {
+        fx_q16_t share = quiet ? 0 : tone_share(goertzel_power(&detectors[d], count), count, stats->ac_power);
+        update_state(d, share, count);
+    }
+}
+
+bool tone_detector_pop_event(ToneEvent *event)
+{
+    return spsc_queue_pop(&event_queue, event);
+}
+
+const ToneDetectorConfig *tone_detector_config(uint8_t detector)
+{
+    return detector < detector_count ? &tone_configs[detector] : NULL;
+}
+
+uint32_t tone_detector_get_dropped(void)
+{
+    return event_queue.dropped;
+}
@@ -0,0 +1,286 @@
+#!/usr/bin/env python3
+"""
+Converte as fontes de ssd1306_fonts.c para faixas de página.
+
+As tabelas originais guardam cada glifo linha a linha (uint16_t por linha,
+bit 15 = coluna 0). O SSD1306 organiza a RAM em páginas de 8 linhas, com um
+byte por coluna (bit 0 = linha de cima). Este script transpõe cada glifo
+para esse formato: para cada página do glifo, um byte por coluna. Assim o
+ssd1306_WriteChar() copia bytes inteiros para o framebuffer.
+
+Com --scan e/ou --manifest as tabelas são reduzidas aos glifos usados:
+- só entram as fontes citadas nos arquivos ou no manifesto;
+- os glifos vêm dos textos passados a ssd1306_WriteString()/WriteChar()
+  e dos formatos de sprintf()/snprintf() (%d vira dígitos e '-', etc.);
+- o manifesto acrescenta glifos que não aparecem no código ("%s", textos
+  montados em tempo de execução).
+Cada fonte reduzida ganha uma tabela de remapeamento caractere -> glifo.
+Caracteres fora do subconjunto são desenhados como espaço.
+
+Uso: font_pages.py <ssd1306_fonts.c> <saida.c> [--scan arquivo.c ...] [--manifest glifos.txt]
+"""
+
+import argparse
+import re
+import sys
+
+FIRST_CHAR = 32
+LAST_CHAR = 126
+
+ARRAY_RE = re.compile(r"static\s+const\s+(uint16_t|uint8_t)\s+(\w+)\s*\[\s*\]\s*=\s*\{(.*?)\}\s*;", re.S)
+FONT_RE = re.compile(
+    r"const\s+SSD1306_Font_t\s+(\w+)\s*=\s*\{\s*(\d+)\s*,\s*(\d+)\s*,\s*(\w+)\s*,\s*(\w+)\s*(?:,\s*\w+\s*)*\}\s*;")
+GUARD_RE = re.compile(r"^\s*#\s*(ifdef|ifndef|if|endif)\b\s*(\w*)", re.M)
+
+
+def strip_comments(text):
+    """Remove comentários preservando as quebras de linha."""
+    def blank(match):
+        return re.sub(r"[^\n]", " ", match.group(0))
+    return re.sub(r"/\*.*?\*/|//[^\n]*", blank, text, flags=re.S)
+
+
+def guard_at(guards, pos):
+    """Guarda #ifdef mais interna ativa na posição pos."""
+    stack = []
+    for start, kind, name in guards:
+        if start > pos:
+            break
+        if kind == "endif":
+            stack.pop()
+        else:
+            stack.append(name if kind == "ifdef" else None)
+    return stack[-1] if stack else None
+
+
+def parse_fonts(source):
+    text = strip_comments(source)
+    guards = [(m.start(), m.group(1), m.group(2)) for m in GUARD_RE.finditer(text)]
+
+    arrays = {}
+    for m in ARRAY_RE.finditer(text):
+        values = [int(v, 0) for v in re.findall(r"0[xX][0-9a-fA-F]+|\d+", m.group(3))]
+        arrays[m.group(2)] = values
+
+    fonts = []
+    for m in FONT_RE.finditer(text):
+        name, width, height, data, char_width = m.groups()
+        if len(arrays[data]) < (LAST_CHAR - FIRST_CHAR + 1) * int(height):
+            raise ValueError("%s: tabela %s incompleta" % (name, data))
+        fonts.append({
+            "name": name,
+            "width": int(width),
+            "height": int(height),
+            "data": arrays[data],
+            "data_name": data,
+            "char_width": arrays[char_width] if char_width != "NULL" else None,
+            "guard": guard_at(guards, m.start()),
+        })
+    return fonts
+
+
+def glyph_to_pages(rows, width, height):
+    """Transpõe um glifo de linhas de 16 bits para páginas de colunas."""
+    pages = (height + 7) // 8
+    strips = []
+    for page in range(pages):
+        for col in range(width):
+            byte = 0
+            for bit in range(8):
+                row = page * 8 + bit
+                if row < height and (rows[row] << col) & 0x8000:
+                    byte |= 1 << bit
+            strips.append(byte)
+    return strips
+
+
+def c_char(code):
+    # Entre aspas: uma barra invertida no fim da linha continuaria o comentário
+    return "'%s'" % chr(code)
+
+
+# Caracteres que cada conversão de printf pode produzir
+DIGITS = "0123456789"
+CONVERSION_CHARS = {
+    "d": DIGITS + "-", "i": DIGITS + "-", "u": DIGITS, "o": "01234567",
+    "x": DIGITS + "abcdef", "X": DIGITS + "ABCDEF",
+    "f": DIGITS + "-.", "F": DIGITS + "-.", "e": DIGITS + "-.+e", "E": DIGITS + "-.+E",
+    "g": DIGITS + "-.+e", "G": DIGITS + "-.+E", "%": "%",
+}
+FORMAT_RE = re.compile(r"%([-+ #0]*)(\d+|\*)?(?:\.(\d+|\*))?(hh|h|ll|l|z|j|t|L)?([diouxXeEfFgGcsp%])")
+LITERAL = r'"((?:[^"\\\n]|\\.)*)"'
+DRAW_RE = re.compile(r"\bssd1306_(?:WriteString|WriteStringWrapped|ScrollTextHorizontal)\s*\(\s*" + LITERAL)
+FORMAT_CALL_RE = re.compile(r"\bs(?:n)?printf\s*\([^;\"]*?" + LITERAL)
+CHAR_RE = re.compile(r"\bssd1306_WriteChar\s*\(\s*'(\\.|[^'\\])'")
+FONT_NAME_RE = re.compile(r"\b(Font_\w+)\b")
+
+
+def unescape(literal):
+    return bytes(literal, "utf-8").decode("unicode_escape")
+
+
+def printable(chars):
+    return {c for c in chars if FIRST_CHAR <= ord(c) <= LAST_CHAR}
+
+
+def format_chars(fmt, where, warnings, acknowledged):
+    """Caracteres que um formato de printf pode gerar."""
+    chars = set(FORMAT_RE.sub("", fmt))
+    for m in FORMAT_RE.finditer(fmt):
+        flags, conversion = m.group(1), m.group(5)
+        if conversion in CONVERSION_CHARS:
+            chars |= set(CONVERSION_CHARS[conversion])
+            chars |= set(flags) & {"+"}
+        elif fmt not in acknowledged:
+            warnings.append("%s: \"%s\" usa %%%s; declare os glifos e o formato no manifesto" % (where, fmt, conversion))
+    return chars
+
+
+def scan_sources(paths, warnings, acknowledged=frozenset()):
+    """Fontes citadas e glifos dos textos desenhados nos arquivos.
+
+    Os formatos em acknowledged já têm os glifos de %s e %c declarados no
+    manifesto e não geram aviso.
+    """
+    fonts, chars = set(), set()
+    for path in paths:
+        with open(path, encoding="utf-8") as f:
+            text = strip_comments(f.read())
+        fonts |= set(FONT_NAME_RE.findall(text))
+        for m in DRAW_RE.finditer(text):
+            chars |= set(unescape(m.group(1)))
+        for m in FORMAT_CALL_RE.finditer(text):
+            chars |= format_chars(unescape(m.group(1)), path, warnings, acknowledged)
+        for m in CHAR_RE.finditer(text):
+            chars |= set(unescape(m.group(1)))
+    return fonts, printable(chars)
+
+
+def read_manifest(path):
+    """Linhas "Font_XxY: caracteres" e 'formato: "..."'; '#' começa um comentário.
+
+    Retorna os glifos extras por fonte e os formatos reconhecidos.
+    """
+    extra, acknowledged = {}, set()
+    with open(path, encoding="utf-8") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if not line.strip() or line.lstrip().startswith("#"):
+                continue
+            name, _, chars = line.partition(":")
+            if name.strip() == "formato":
+                m = re.fullmatch(r"\s*" + LITERAL + r"\s*", chars)
+                if m:
+                    acknowledged.add(unescape(m.group(1)))
+                continue
+            extra.setdefault(name.strip(), set()).update(printable(chars.strip()))
+    return extra, acknowledged
+
+
+def emit_font(font, out, subset=None):
+    width, height = font["width"], font["height"]
+    pages = (height + 7) // 8
+    base = font["data_name"]
+    codes = list(range(FIRST_CHAR, LAST_CHAR + 1))
+    if subset is not None:
+        codes = sorted({ord(" ")} | {ord(c) for c in subset})
+
+    out.append("#ifdef %s" % font["guard"] if font["guard"] else "#if 1")
+    out.append("// %s: %d glifos, %d página(s) x %d colunas por glifo" % (font["name"], len(codes), pages, width))
+    out.append("static const uint8_t %s_pages[] = {" % base)
+    for code in codes:
+        index = code - FIRST_CHAR
+        rows = font["data"][index * height:(index + 1) * height]
+        strips = glyph_to_pages(rows, width, height)
+        out.append("    " + ", ".join("0x%02X" % b for b in strips) + ",  // " + c_char(code))
+    out.append("};")
+    size = len(codes) * pages * width
+
+    remap = "NULL"
+    if subset is not None:
+        # Caracteres ausentes apontam para o espaço (glifo 0)
+        remap = "%s_remap" % base
+        slots = [codes.index(c) if c in codes else 0 for c in range(FIRST_CHAR, LAST_CHAR + 1)]
+        out.append("static const uint8_t %s[] = {" % remap)
+        for row in range(0, len(slots), 16):
+            out.append("    " + ", ".join("%d" % v for v in slots[row:row + 16]) + ",")
+        out.append("};")
+        size += len(slots)
+
+    char_width = "NULL"
+    if font["char_width"] is not None:
+        glyphs = LAST_CHAR - FIRST_CHAR + 1
+        char_width = "%s_char_width" % base
+        out.append("static const uint8_t %s[] = {" % char_width)
+        out.append("    " + ", ".join(str(w) for w in font["char_width"][:glyphs]))
+        out.append("};")
+        size += glyphs
+
+    out.append("const SSD1306_Font_t %s = {%d, %d, NULL, %s, %s_pages, %s};" % (
+        font["name"], width, height, char_width, base, remap))
+    out.append("#endif")
+    out.append("")
+    return len(codes), size
+
+
+def original_size(font):
+    """Bytes das tabelas de ssd1306_fonts.c (linhas de 16 bits e larguras)."""
+    glyphs = LAST_CHAR - FIRST_CHAR + 1
+    size = glyphs * font["height"] * 2
+    if font["char_width"] is not None:
+        size += glyphs
+    return size
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description="Converte as fontes do SSD1306 para faixas de página.")
+    parser.add_argument("fonts", help="ssd1306_fonts.c")
+    parser.add_argument("output", help="arquivo .c gerado")
+    parser.add_argument("--scan", nargs="+", default=[], help="arquivos com os textos desenhados")
+    parser.add_argument("--manifest", help="glifos extras por fonte")
+    args = parser.parse_args(argv[1:])
+
+    with open(args.fonts, encoding="utf-8") as f:
+        fonts = parse_fonts(f.read())
+    if not fonts:
+        sys.stderr.write("font_pages.py: nenhuma fonte encontrada em %s\n" % args.fonts)
+        return 1
+
+    subsetting = bool(args.scan or args.manifest)
+    warnings = []
+    extra, acknowledged = read_manifest(args.manifest) if args.manifest else ({}, set())
+    used_fonts, used_chars = scan_sources(args.scan, warnings, acknowledged)
+    used_fonts |= set(extra)
+
+    out = [
+        "// Gerado por tools/font_pages.py a partir de ssd1306_fonts.c. Não edite.",
+        "#include \"drivers/display-lcd/ssd1306_fonts.h\"",
+        "",
+    ]
+    report = []
+    before_total = after_total = 0
+    for font in fonts:
+        before = original_size(font)
+        before_total += before
+        if subsetting and font["name"] not in used_fonts:
+            report.append("  %-11s não usada, removida (-%d bytes)" % (font["name"], before))
+            continue
+        subset = (used_chars | extra.get(font["name"], set())) if subsetting else None
+        glyphs, after = emit_font(font, out, subset)
+        after_total += after
+        report.append("  %-11s %3d glifos, %5d -> %5d bytes" % (font["name"], glyphs, before, after))
+
+    with open(args.output, "w", encoding="utf-8") as f:
+        f.write("\n".join(out))
+
+    print("font_pages: tabelas de fontes %d -> %d bytes (%d bytes economizados)" % (
+        before_total, after_total, before_total - after_total))
+    for line in report:
+        print(line)
+    for warning in warnings:
+        print("font_pages: aviso: " + warning)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))